@@ -1,342 +1,580 @@
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include "stack.h"
 #include "bst.h"
 
-char* strdup(const char* s);
+#define BST_MAX_HEIGHT 96
+#define BST_SLAB_SIZE (256 * 1024)
+#define BST_ALIGNMENT sizeof(void*)
+#define BST_MAX_THREADS 64
 
 /*******************************************************************
  * Structures			
  ******************************************************************/
 
+/*'height' is the number of nodes in the longest path from the node
+down to a leaf (1 for a leaf), and 'size' the number of nodes in its
+subtree (itself included). 'parent' is NULL for the root.
+'key_size' is only used with an arena: it is the size of the memory the
+key is in (0 if it does not fit in an unsigned int).*/
 typedef struct bst_node{
 	struct bst_node* left;
 	struct bst_node* right;
+	struct bst_node* parent;
 	char* key;
 	void* data;
+	size_t size;
+	int height;
+	unsigned int key_size;
 }bst_node_t;
 
+typedef struct bst_slab{
+	struct bst_slab* next;
+	char memory[];
+}bst_slab_t;
+
+/*Nodes and keys of a bst created with an arena are taken one after the
+other from slabs of BST_SLAB_SIZE bytes (or bigger, for a bigger key),
+and are only freed all together by bst_destroy. 'used' is the number of
+bytes taken from the first slab, which has 'capacity' bytes.
+Removed nodes are kept in 'free_nodes' (linked through their right sons),
+with the memory of their keys, to be used again.*/
+typedef struct bst_arena{
+	bst_slab_t* slabs;
+	size_t used;
+	size_t capacity;
+	bst_node_t* free_nodes;
+}bst_arena_t;
+
+/*Nodes from 'lo' to 'hi' (not included) of a bst built from sorted keys,
+that make the subtree 'link' has to point to. 'depth' is the number of
+nodes above it.*/
+typedef struct bst_range{
+	size_t lo;
+	size_t hi;
+	bst_node_t* parent;
+	bst_node_t** link;
+	size_t depth;
+}bst_range_t;
+
+/*Work of one thread when building a bst from sorted keys. First it
+measures its keys (from 'lo' to 'hi', not included), saving in 'key_bytes'
+the memory they take and in 'sorted' whether they are in order. Then it
+copies them to 'key_memory' and links the subtrees 'first', 'first' +
+'step', ... of 'subtrees'.*/
+typedef struct bst_build{
+	bst_node_t* nodes;
+	const char* const* keys;
+	void* const* values;
+	bst_compare_key_t cmp;
+	size_t lo;
+	size_t hi;
+	size_t key_bytes;
+	bool sorted;
+	char* key_memory;
+	const bst_range_t* subtrees;
+	size_t subtree_count;
+	size_t first;
+	size_t step;
+}bst_build_t;
+
+/*The tree is kept as an AVL tree: the heights of the two subtrees of every
+node differ at most by one, so its height is at most 1.44 * log2(n + 2)
+(never more than BST_MAX_HEIGHT). Operations walk the tree without
+recursion, saving the links they go through in local arrays.*/
 struct bst{
 	bst_node_t* root;
 	bst_compare_key_t cmp; 
 	bst_destroy_data_t destroy_data;
 	size_t items; 
-};
-
-struct bst_iter {
-	stack_t* nodes;
+	bool uses_arena;
+	bst_arena_t arena;
 };
 
 /*******************************************************************
  * Auxiliary Functions		
  ******************************************************************/
 
-/*Creates a new node.*/
-bst_node_t* bst_node_create(const char* key, void* data){
-	bst_node_t* node = malloc(sizeof(bst_node_t));
+/*Takes 'size' bytes from the arena. Returns NULL in the case of an
+error.*/
+void* bst_arena_alloc(bst_arena_t* arena, size_t size){
+	size = (size + BST_ALIGNMENT - 1) / BST_ALIGNMENT * BST_ALIGNMENT;
 
-	if(!node){ 
-		return NULL;
+	if(!arena->slabs || arena->capacity - arena->used < size){
+		size_t capacity = size > BST_SLAB_SIZE ? size : BST_SLAB_SIZE;
+		bst_slab_t* slab = malloc(sizeof(bst_slab_t) + capacity);
+
+		if(!slab){
+			return NULL;
+		}
+
+		slab->next = arena->slabs;
+		arena->slabs = slab;
+		arena->used = 0;
+		arena->capacity = capacity;
 	}
-	
-	node->key = malloc(sizeof(char) * (strlen(key)+1)); //\0
-	
-	if(!node->key){	
-		free(node);
-		return NULL;
+
+	void* memory = arena->slabs->memory + arena->used;
+	arena->used += size;
+	return memory;
+}
+
+/*Returns a node from the arena whose key can hold 'key_size' bytes: a
+removed one if there is any, or a new one. Returns NULL in the case of an
+error.*/
+bst_node_t* bst_arena_node(bst_arena_t* arena, size_t key_size){
+	bst_node_t* node = arena->free_nodes;
+
+	if(node){
+		arena->free_nodes = node->right;
+	}
+
+	else{
+		node = bst_arena_alloc(arena, sizeof(bst_node_t));
+
+		if(!node){
+			return NULL;
+		}
+
+		node->key_size = 0;
+	}
+
+	if(node->key_size < key_size){
+		char* key = bst_arena_alloc(arena, key_size);
+
+		if(!key){
+			node->right = arena->free_nodes;
+			arena->free_nodes = node;
+			return NULL;
+		}
+
+		node->key = key;
+		node->key_size = key_size <= UINT_MAX ? (unsigned int)key_size : 0;
+	}
+
+	return node;
+}
+
+/*Creates a new node, son of 'parent'.*/
+bst_node_t* bst_node_create(bst_t* bst, const char* key, void* data, bst_node_t* parent){
+	size_t key_size = strlen(key) + 1; //\0
+	bst_node_t* node;
+
+	if(bst->uses_arena){
+		node = bst_arena_node(&bst->arena, key_size);
+
+		if(!node){
+			return NULL;
+		}
+	}
+
+	else{
+		node = malloc(sizeof(bst_node_t));
+
+		if(!node){ 
+			return NULL;
+		}
+		
+		node->key = malloc(sizeof(char) * key_size);
+		
+		if(!node->key){	
+			free(node);
+			return NULL;
+		}
 	}
 	
-	strcpy(node->key, key);
+	memcpy(node->key, key, key_size);
 	node->data = data;
 	node->left = NULL;
 	node->right = NULL;
+	node->parent = parent;
+	node->height = 1;
+	node->size = 1;
 	return node;
 }
 
-/*Stores a new node in the bst.*/
-bool bst_node_store(bst_node_t* node, bst_t* bst, const char* key, void* data){
-	if(bst->cmp(node->key, key) == 0){
-		void* old_data = node->data;
-		node->data = data;
+/*Frees the node (with an arena, it is kept to be used again).*/
+void bst_node_destroy(bst_t* bst, bst_node_t* node){
+	if(bst->uses_arena){
+		node->right = bst->arena.free_nodes;
+		bst->arena.free_nodes = node;
+		return;
+	}
 
-		if(bst->destroy_data) {
-			bst->destroy_data(old_data);
+	free(node->key);
+	free(node);
+}
+
+int bst_node_height(const bst_node_t* node){
+	return node ? node->height : 0;
+}
+
+size_t bst_node_size(const bst_node_t* node){
+	return node ? node->size : 0;
+}
+
+/*Updates the height and size of the node from those of its sons.*/
+void bst_node_update(bst_node_t* node){
+	int left = bst_node_height(node->left);
+	int right = bst_node_height(node->right);
+	node->height = (left > right ? left : right) + 1;
+	node->size = bst_node_size(node->left) + bst_node_size(node->right) + 1;
+}
+
+/*Rotates to the left the subtree the link points to.*/
+void bst_rotate_left(bst_node_t** link){
+	bst_node_t* node = *link;
+	bst_node_t* right = node->right;
+	node->right = right->left;
+
+	if(node->right){
+		node->right->parent = node;
+	}
+
+	right->left = node;
+	right->parent = node->parent;
+	node->parent = right;
+	bst_node_update(node);
+	bst_node_update(right);
+	*link = right;
+}
+
+/*Rotates to the right the subtree the link points to.*/
+void bst_rotate_right(bst_node_t** link){
+	bst_node_t* node = *link;
+	bst_node_t* left = node->left;
+	node->left = left->right;
+
+	if(node->left){
+		node->left->parent = node;
+	}
+
+	left->right = node;
+	left->parent = node->parent;
+	node->parent = left;
+	bst_node_update(node);
+	bst_node_update(left);
+	*link = left;
+}
+
+/*Updates the height and size of the subtree the link points to, and
+rotates it if its subtrees' heights differ by two (after an insertion or
+removal below it).*/
+void bst_node_balance(bst_node_t** link){
+	bst_node_t* node = *link;
+	int balance = bst_node_height(node->left) - bst_node_height(node->right);
+
+	if(balance > 1){
+		if(bst_node_height(node->left->left) < bst_node_height(node->left->right)){
+			bst_rotate_left(&node->left);
 		}
 
-		bst->items-=1; //Because the storing function adds one.
+		bst_rotate_right(link);
 	}
 
-	else if(bst->cmp(key, node->key)<0){
-		
-		if(node->left){
-			return bst_node_store(node->left, bst, key, data);
+	else if(balance < -1){
+		if(bst_node_height(node->right->right) < bst_node_height(node->right->left)){
+			bst_rotate_right(&node->right);
 		}
 		
-		else{
-			node->left = bst_node_create(key, data);
-			if(!node->left) {
-				return false;
-			}
-		}
+		bst_rotate_left(link);
 	}
 	
 	else{
+		bst_node_update(node);
+	}
+}
 		
-		if(node->right){
-			return bst_node_store(node->right, bst, key, data);
-		}
-		
-		else{
-			node->right = bst_node_create(key, data);
+/*Balances the subtrees of the links in 'path', from the deepest one to the
+root.*/
+void bst_rebalance(bst_node_t** path[], size_t depth){
+	while(depth > 0){
+		bst_node_balance(path[--depth]);
+	}
+}
+
+/*Searches for the node with the given key. Saves in 'path' the links
+followed from the root, so that 'path[depth]' is the link that points to
+the node (or where it would be), and returns 'depth'.*/
+size_t bst_node_search_path(const bst_t* bst, const char* key, bst_node_t** path[]){
+	bst_node_t** link = (bst_node_t**)&bst->root;
+	size_t depth = 0;
 
-			if(!node->right) {
-				return false;
-			}
+	while(*link){
+		int comparison = bst->cmp(key, (*link)->key);
+
+		if(comparison == 0){
+			break;
 		}
+		
+		path[depth++] = link;
+		link = comparison < 0 ? &(*link)->left : &(*link)->right;
 	}
 	
-	return true;
+	path[depth] = link;
+	return depth;
 }
 
-/* Searches for a node with the given key, starting from the given node.*/
-bst_node_t* bst_node_search(bst_compare_key_t cmp, bst_node_t* node, const char* key, bool get_father, bst_node_t* father){
-	if(cmp(node->key, key) == 0){
-		if(get_father){ 
-			return father;
+/* Searches for a node with the given key.*/
+bst_node_t* bst_node_search(const bst_t* bst, const char* key){
+	bst_node_t* node = bst->root;
+
+	while(node){
+		int comparison = bst->cmp(key, node->key);
+
+		if(comparison == 0){
+			return node;
 		}
 
-		return node;
+		node = comparison < 0 ? node->left : node->right;
 	}
 	
-	if(cmp(key, node->key) < 0){		
-		if(node->left){
-			return bst_node_search(cmp, node->left, key, get_father, node);
-		}
+	return NULL;
+}
 		
-		return NULL;
+/* Removes the node the link 'path[depth]' points to, and balances the
+tree. Returns its data.*/
+void* bst_node_remove(bst_t* bst, bst_node_t** path[], size_t depth){
+	bst_node_t* node = *path[depth];
+	void* data = node->data;
+
+	if(!node->left || !node->right){
+		bst_node_t* son = node->left ? node->left : node->right;
+		*path[depth] = son;
+
+		if(son){
+			son->parent = node->parent;
+		}
 	}
 	
 	else{
-		if(node->right){
-			return bst_node_search(cmp, node->right, key, get_father, node);
+		/*The node is replaced by the leftmost node of its right subtree,
+		which is unlinked from there first.*/
+		size_t successor_depth = depth + 1;
+		path[successor_depth] = &node->right;
+
+		while((*path[successor_depth])->left){
+			path[successor_depth + 1] = &(*path[successor_depth])->left;
+			successor_depth++;
 		}
 
-		return NULL;
-	}
-}
+		bst_node_t* successor = *path[successor_depth];
+		*path[successor_depth] = successor->right;
 
-/*Returns the leftmost node, starting from the given node.*/
-bst_node_t* bst_node_min(bst_node_t* node){
-	while(node->left){
-		node = node -> left;
-	}
+		if(successor->right){
+			successor->right->parent = successor->parent;
+		}
 
-	return node;
-}
+		successor->left = node->left;
+		successor->right = node->right;
+		successor->left->parent = successor;
 
-/*Returns the rightmost node, starting from the given node.*/
-bst_node_t* bst_node_max(bst_node_t* node){
-	while(node->right){
-		node = node -> right;
+		if(successor->right){
+			successor->right->parent = successor;
+		}
+
+		successor->parent = node->parent;
+		*path[depth] = successor;
+		path[depth + 1] = &successor->right;
+		depth = successor_depth;
 	}
 
-	return node;
+	bst_rebalance(path, depth);
+	bst_node_destroy(bst, node);
+	return data;
 }
 
-/* Swaps two nodes (interchanging their keys and data).
-Returns false in the case of an error.*/
-bool bst_node_swap(bst_node_t* node_a, bst_node_t* node_b){
-	/*key swap*/
-	char* key_aux = strdup(node_a->key);
-	free(node_a->key);
-	node_a->key = strdup(node_b->key);
-	free(node_b->key);
-	node_b->key = strdup(key_aux);
-	free(key_aux);
-	
-	/*value swap*/
-	void* value_aux = NULL;
-	value_aux = node_a->data;
-	node_a->data = node_b->data;
-	node_b->data = value_aux;
-	return true;
-}
+/* Auxiliary function for destroying the bst. Left sons are rotated up
+until the node has none, so no stack is needed. Nodes from an arena are
+not freed here.*/
+void bst_destroy_aux(bst_t* bst){
+	bst_node_t* node = bst->root;
 
-/* Removes the node with the given key, searching from the given node.*/
-void* bst_node_remove(bst_node_t* node, bool is_left, bst_node_t* father, bst_t* bst, const char* key);
+	while(node){
+		if(node->left){
+			bst_node_t* left = node->left;
+			node->left = left->right;
+			left->right = node;
+			node = left;
+			continue;
+		}
 
-void bst_node_remove_leaf(bool is_left, bst_node_t* father){
-	if(is_left) {
-		father->left = NULL;
-	}
+		bst_node_t* right = node->right;
+
+		if(bst->destroy_data){
+			bst->destroy_data(node->data);
+		}
+		
+		if(!bst->uses_arena){
+			free(node->key);
+			free(node);
+		}
 
-	else {
-		father->right = NULL;
+		node = right;
 	}
 }
 
-void bst_node_remove_1_son(bst_node_t* node, bool is_left, bst_node_t* father){
-	if(node->right && !node->left){
+/* Returns the height of a balanced subtree of 'size' nodes.*/
+int bst_balanced_height(size_t size){
+	int height = 0;
 
-		if(is_left) {
-			father->left = node->right;
+	for(; size > 0; size >>= 1){
+		height++;
+	}
+
+	return height;
+}
+
+/* Links the nodes of the range as a balanced subtree: its root is the node
+in the middle, and the nodes before and after it make its left and right
+subtrees. Subtrees 'levels' below the range are not linked, but saved in
+'pending' (which must have room for 2^'levels' of them). Returns the
+number of pending subtrees.*/
+size_t bst_link_range(bst_node_t* nodes, bst_range_t range, size_t levels, bst_range_t* pending){
+	bst_range_t ranges[BST_MAX_HEIGHT];
+	size_t count = 0;
+	size_t pending_count = 0;
+	ranges[count++] = range;
+
+	while(count > 0){
+		bst_range_t current = ranges[--count];
+
+		if(current.lo == current.hi){
+			*current.link = NULL;
+			continue;
 		}
 
-		else {
-			father->right = node->right;
+		if(current.depth - range.depth == levels){
+			pending[pending_count++] = current;
+			continue;
 		}
 
-		return;
+		size_t middle = current.lo + (current.hi - current.lo) / 2;
+		bst_node_t* node = &nodes[middle];
+		node->parent = current.parent;
+		node->height = bst_balanced_height(current.hi - current.lo);
+		node->size = current.hi - current.lo;
+		*current.link = node;
+		ranges[count++] = (bst_range_t){middle + 1, current.hi, node, &node->right, current.depth + 1};
+		ranges[count++] = (bst_range_t){current.lo, middle, node, &node->left, current.depth + 1};
 	}
-		
-	if (!node->right && node->left){
 
-		if(is_left) {
-			father->left = node->left;
-		}
+	return pending_count;
+}
 
-		else {
-			father->right = node->left;
+/* First part of the work of a thread building a bst (see bst_build_t).*/
+void* bst_build_measure(void* argument){
+	bst_build_t* build = argument;
+	build->key_bytes = 0;
+	build->sorted = true;
+
+	for(size_t i = build->lo; i < build->hi; i++){
+		build->key_bytes += strlen(build->keys[i]) + 1; //\0
+
+		if(i > 0 && build->cmp(build->keys[i - 1], build->keys[i]) >= 0){
+			build->sorted = false;
 		}
 	}
+
+	return NULL;
 }
 
-void* bst_node_remove_2_sons(bst_node_t* node, bool is_left, bst_node_t* father, bst_t* bst){
-	bool esleft = false;
-	bst_node_t* node_aux = bst_node_min(node->right);
-	bst_node_t* father_aux = bst_node_search(bst->cmp, bst->root, node_aux->key, true, NULL);
-			
-	if(!bst_node_swap(node, node_aux)) {
-		return NULL;
+/* Second part of the work of a thread building a bst (see bst_build_t).*/
+void* bst_build_fill(void* argument){
+	bst_build_t* build = argument;
+	char* key = build->key_memory;
+
+	for(size_t i = build->lo; i < build->hi; i++){
+		size_t key_size = strlen(build->keys[i]) + 1; //\0
+		bst_node_t* node = &build->nodes[i];
+		node->key = memcpy(key, build->keys[i], key_size);
+		node->key_size = key_size <= UINT_MAX ? (unsigned int)key_size : 0;
+		node->data = build->values ? build->values[i] : NULL;
+		key += key_size;
 	}
 
-	if(bst->cmp(father_aux->left->key,node_aux->key)==0) {
-		esleft = true;
-	}	
+	for(size_t i = build->first; i < build->subtree_count; i += build->step){
+		bst_link_range(build->nodes, build->subtrees[i], SIZE_MAX, NULL);
+	}
 
-	return bst_node_remove(node_aux, esleft, father_aux, bst, node_aux->key);
+	return NULL;
 }
 
-void* bst_node_remove(bst_node_t* node, bool is_left, bst_node_t* father, bst_t* bst, const char* key){	
-	if(bst->cmp(node->key, key) == 0){
-		void* data = node->data;
-		
-		//root
-		if(!father){	
-			if(!node->left && !node->right){
-				bst->root = NULL;
-			}
-				
-			else{
-				bst_node_t* node_aux = NULL;
-
-				if(node->right){					
-					node_aux = bst_node_min(node->right);
-					
-					if(!bst_node_swap(node, node_aux)) {
-						return NULL;
-					}
-
-					bst->root = node;
-					return bst_node_remove(node->right, false, node, bst, node_aux->key);
-				}
-
-				node_aux = bst_node_max(node->left);
-				
-				if(!bst_node_swap(node, node_aux)){ 
-					return NULL;
-				}
-
-				bst->root = node;
-				return bst_node_remove(node->left, true, node, bst, node_aux->key); 
-			}
-		}
-		
-		else if(!node->right && !node->left){
-			bst_node_remove_leaf(is_left, father);
-		}
+/* Runs 'work' for every build, each one in its own thread (the first one
+in this thread, as well as those whose thread could not be created).*/
+void bst_build_run(void* work(void*), bst_build_t* builds, size_t threads){
+	pthread_t ids[BST_MAX_THREADS];
+	bool started[BST_MAX_THREADS];
 
-		else if(!node->right || !node->left){
-			bst_node_remove_1_son(node, is_left, father);
-		}
-		
-		else{
-			return bst_node_remove_2_sons(node, is_left, father, bst);
-		}
-		
-		free(node->key);
-		free(node);
-		return data;
+	for(size_t i = 1; i < threads; i++){
+		started[i] = pthread_create(&ids[i], NULL, work, &builds[i]) == 0;
 	}
-	
-	else if(bst->cmp(key, node->key)<0)	{
-		if(node->left){ 
-			return bst_node_remove(node->left, true, node, bst, key);
+
+	work(&builds[0]);
+
+	for(size_t i = 1; i < threads; i++){
+		if(started[i]){
+			pthread_join(ids[i], NULL);
 		}
 
-		return NULL;
-	}
-	
-	else{
-		if(node->right) {
-			return bst_node_remove(node->right, false, node, bst, key);
+		else{
+			work(&builds[i]);
 		}
-		return NULL;
 	}
 }
 
-/* Auxiliary function for destroying the bst.*/
-void bst_destroy_aux(bst_node_t* node, bst_destroy_data_t destroy_data){
-	if(node->left){
-		bst_destroy_aux(node->left, destroy_data);
-	}
-	
-	if(node->right){
-		bst_destroy_aux(node->right, destroy_data);
-	}
-	
-	if(destroy_data){
-		destroy_data(node->data);
+/* Returns the leftmost node of the subtree (NULL if it is empty).*/
+const bst_node_t* bst_node_first(const bst_node_t* node){
+	while(node && node->left){
+		node = node->left;
 	}
 
-	free(node->key);
-	free(node);
+	return node;
 }
 
-/*Auxiliary function for the iteration of the bst.
-Returns false if the iteration must be stopped.*/
-bool bst_right_aux(bst_node_t* node, bool visit(const char *, void *, void *), void *extra){
-	if(!node) {
-		return true;
-	}
+/* Returns the node with the first key that is not less than 'from' (NULL
+if there is none).*/
+const bst_node_t* bst_node_first_from(const bst_t* bst, const char* from){
+	const bst_node_t* node = bst->root;
+	const bst_node_t* first = NULL;
 
-	if(bst_right_aux(node->left, visit, extra)){	
-		if(!visit(node->key, node->data, extra)) {
-			return false;
+	while(node){
+		if(bst->cmp(from, node->key) > 0){
+			node = node->right;
+			continue;
 		}
-		
-		return bst_right_aux(node->right, visit, extra);
+
+		first = node;
+		node = node->left;
 	}
-	
-	return false;
-}
 
-/* Stacks every left son of the given node.
-Returns false in case of an error.*/
-bool stack_left(stack_t* stack, bst_node_t* node) {
-	bst_node_t* current = node;	
+	return first;
+}
 
-	while(current){	
-		if(!stack_push(stack, current)) {
-			return false;
-		}
+/* Returns the node that follows the given one in order (NULL if it is the
+last one): the leftmost node of its right subtree or, if it has none, the
+first ancestor reached from a left son.*/
+const bst_node_t* bst_node_next(const bst_node_t* node){
+	if(node->right){
+		return bst_node_first(node->right);
+	}
 
-		current = current->left;
+	while(node->parent && node->parent->right == node){
+		node = node->parent;
 	}
 
-	return true;
+	return node->parent;
+}
+
+/* Moves the iterator to the end if its current key is not before its end.*/
+void bst_iter_check_end(bst_iter_t* iter){
+	if(iter->end && iter->current && iter->cmp(iter->current->key, iter->end) >= 0){
+		iter->current = NULL;
+	}
 }
 
 /*******************************************************************
@@ -356,59 +594,144 @@ bst_t* bst_create(bst_compare_key_t cmp, bst_destroy_data_t destroy_data){
 	bst->cmp = cmp;
 	bst->destroy_data = destroy_data;
 	bst->items = 0;
+	bst->uses_arena = false;
+	bst->arena.slabs = NULL;
+	bst->arena.used = 0;
+	bst->arena.capacity = 0;
+	bst->arena.free_nodes = NULL;
+	return bst;
+}
+
+bst_t* bst_create_with_arena(bst_compare_key_t cmp, bst_destroy_data_t destroy_data){
+	bst_t* bst = bst_create(cmp, destroy_data);
+
+	if(bst) {
+		bst->uses_arena = true;
+	}
+
+	return bst;
+}
+
+bst_t* bst_create_from_sorted(bst_compare_key_t cmp, bst_destroy_data_t destroy_data,
+                              const char* const* keys, void* const* values, size_t n){
+	return bst_create_from_sorted_parallel(cmp, destroy_data, keys, values, n, 1);
+}
+
+bst_t* bst_create_from_sorted_parallel(bst_compare_key_t cmp, bst_destroy_data_t destroy_data,
+                                       const char* const* keys, void* const* values, size_t n,
+                                       size_t threads){
+	bst_t* bst = bst_create_with_arena(cmp, destroy_data);
+
+	if(!bst || n == 0) {
+		return bst;
+	}
+
+	threads = threads < 1 ? 1 : threads > BST_MAX_THREADS ? BST_MAX_THREADS : threads;
+	threads = threads > n ? n : threads;
+	bst_build_t builds[BST_MAX_THREADS];
+
+	for(size_t i = 0; i < threads; i++){
+		builds[i] = (bst_build_t){.keys = keys, .values = values, .cmp = cmp,
+		                          .lo = n * i / threads, .hi = n * (i + 1) / threads};
+	}
+
+	bst_build_run(bst_build_measure, builds, threads);
+	size_t key_bytes = 0;
+	bool sorted = true;
+
+	for(size_t i = 0; i < threads; i++){
+		key_bytes += builds[i].key_bytes;
+		sorted = sorted && builds[i].sorted;
+	}
+
+	/*Every node and key goes in a single slab of the arena.*/
+	bst_slab_t* slab = NULL;
+
+	if(sorted && n <= (SIZE_MAX - sizeof(bst_slab_t) - key_bytes) / sizeof(bst_node_t)){
+		slab = malloc(sizeof(bst_slab_t) + sizeof(bst_node_t) * n + key_bytes);
+	}
+
+	if(!slab){
+		bst_destroy(bst);
+		return NULL;
+	}
+
+	slab->next = NULL;
+	bst->arena.slabs = slab;
+	bst->arena.capacity = sizeof(bst_node_t) * n + key_bytes;
+	bst->arena.used = bst->arena.capacity;
+	bst_node_t* nodes = (bst_node_t*)slab->memory;
+
+	/*The top levels are linked here, and the subtrees below them (at least
+	one for each thread) by the threads.*/
+	size_t levels = 0;
+
+	while(((size_t)1 << levels) < threads){
+		levels++;
+	}
+
+	bst_range_t subtrees[2 * BST_MAX_THREADS];
+	size_t subtree_count = bst_link_range(nodes, (bst_range_t){0, n, NULL, &bst->root, 0}, levels, subtrees);
+	char* key_memory = (char*)(nodes + n);
+
+	for(size_t i = 0; i < threads; i++){
+		builds[i].nodes = nodes;
+		builds[i].key_memory = key_memory;
+		builds[i].subtrees = subtrees;
+		builds[i].subtree_count = subtree_count;
+		builds[i].first = i;
+		builds[i].step = threads;
+		key_memory += builds[i].key_bytes;
+	}
+
+	bst_build_run(bst_build_fill, builds, threads);
+	bst->items = n;
 	return bst;
 }
 
 bool bst_store(bst_t *bst, const char *key, void *data){	
-	if(!bst->root){
-		bst->root = bst_node_create(key, data);
+	bst_node_t** path[BST_MAX_HEIGHT + 1];
+	size_t depth = bst_node_search_path(bst, key, path);
+	bst_node_t* node = *path[depth];
+
+	if(node){
+		void* old_data = node->data;
+		node->data = data;
 
-		if(!bst->root){
-			return false;
+		if(bst->destroy_data) {
+			bst->destroy_data(old_data);
 		}
+
+		return true;
 	}
 	
-	else if(!bst_node_store(bst->root, bst, key, data)){ 
+	node = bst_node_create(bst, key, data, depth > 0 ? *path[depth - 1] : NULL);
+
+	if(!node){
 		return false;
 	}
 
+	*path[depth] = node;
+	bst_rebalance(path, depth);
 	bst->items+=1;
 	return true;
 }
 
 void *bst_remove(bst_t *bst, const char *key){
-	if(!bst->root) {
-		return NULL;
-	}
-	
-	bst_node_t* node = bst_node_search(bst->cmp, bst->root, key, false, NULL);
-	
-	if(!node) {
-		return NULL;
-	}
+	bst_node_t** path[BST_MAX_HEIGHT + 1];
+	size_t depth = bst_node_search_path(bst, key, path);
 
-	bst_node_t* father = bst_node_search(bst->cmp, bst->root, key, true, NULL);
-	bool is_left = false;
-	
-	if(father){
-		if(father->left){
-			if(bst->cmp(father->left->key, node->key)==0){
-				is_left = true;
-			}
-		}
+	if(!*path[depth]) {
+		return NULL;
 	}
 	
-	void* value = bst_node_remove(node, is_left, father, bst, key);
+	void* value = bst_node_remove(bst, path, depth);
 	bst->items-=1;
 	return value;
 }
 
 void *bst_get(const bst_t *bst, const char *key){
-	if(!bst->root) {
-		return NULL;
-	}
-
-	bst_node_t* node = bst_node_search(bst->cmp, bst->root, key, false, NULL);
+	bst_node_t* node = bst_node_search(bst, key);
 	
 	if(!node) {
 		return NULL;
@@ -418,20 +741,67 @@ void *bst_get(const bst_t *bst, const char *key){
 }
 
 bool bst_contains(const bst_t *bst, const char *key){
-	if(!bst->root) {
-		return false;
-	}
-
-	return bst_node_search(bst->cmp, bst->root, key, false, NULL);
+	return bst_node_search(bst, key) != NULL;
 }
 
 size_t bst_size(bst_t *bst){
 	return bst->items;
 }
 
+const char *bst_select(const bst_t *bst, size_t k){
+	const bst_node_t* node = bst->root;
+
+	while(node){
+		size_t left = bst_node_size(node->left);
+
+		if(k == left){
+			return node->key;
+		}
+
+		if(k < left){
+			node = node->left;
+		}
+
+		else{
+			k -= left + 1;
+			node = node->right;
+		}
+	}
+
+	return NULL;
+}
+
+size_t bst_rank(const bst_t *bst, const char *key){
+	const bst_node_t* node = bst->root;
+	size_t rank = 0;
+
+	while(node){
+		int comparison = bst->cmp(key, node->key);
+
+		if(comparison <= 0){
+			node = node->left;
+			continue;
+		}
+
+		rank += bst_node_size(node->left) + 1;
+		node = node->right;
+	}
+
+	return rank;
+}
+
 void bst_destroy(bst_t *bst){
-	if(bst->root) {
-		bst_destroy_aux(bst->root, bst->destroy_data);
+	/*With an arena, nodes are only visited to destroy their data.*/
+	if(bst->root && (!bst->uses_arena || bst->destroy_data)) {
+		bst_destroy_aux(bst);
+	}
+
+	bst_slab_t* slab = bst->arena.slabs;
+
+	while(slab){
+		bst_slab_t* next = slab->next;
+		free(slab);
+		slab = next;
 	}
 		
 	free(bst);
@@ -440,64 +810,79 @@ void bst_destroy(bst_t *bst){
 /*Inner Iterator*/
 
 void bst_visit(bst_t *bst, bool visit(const char *, void *, void *), void *extra){
-	bst_right_aux(bst->root, visit, extra);
+	bst_visit_range(bst, NULL, NULL, visit, extra);
+}
+
+void bst_visit_range(bst_t *bst, const char *from, const char *to,
+                     bool visit(const char *, void *, void *), void *extra){
+	bst_iter_t iter;
+	bst_iter_init(&iter, bst, from, to);
+
+	while(iter.current){
+		if(!visit(iter.current->key, iter.current->data, extra)) {
+			return;
+		}
+
+		bst_iter_next(&iter);
+	}
 }
 
 /*Outer iterator*/
 
 bst_iter_t *bst_iter_create(const bst_t *bst){
-	bst_iter_t* iter = malloc(sizeof(iter));
+	return bst_iter_create_range(bst, NULL, NULL);
+}
+
+bst_iter_t *bst_iter_create_from(const bst_t *bst, const char *from){
+	return bst_iter_create_range(bst, from, NULL);
+}
+
+bst_iter_t *bst_iter_create_range(const bst_t *bst, const char *from, const char *to){
+	/*The copy of 'to' goes right after the iterator.*/
+	size_t end_size = to ? strlen(to) + 1 : 0; //\0
+	bst_iter_t* iter = malloc(sizeof(bst_iter_t) + end_size);
 	
 	if(!iter) {
 		return NULL;
 	}
 	
-	stack_t* nodes = stack_create();
-
-	if(!nodes){ 
-		free(iter);
-		return NULL;
+	if(to){
+		to = memcpy(iter + 1, to, end_size);
 	}
-	
-	iter->nodes = nodes;
 
-	if(!stack_left(iter->nodes, bst->root)){
-		bst_iter_destroy(iter);
-		return NULL;
-	}
-	
+	bst_iter_init(iter, bst, from, to);
 	return iter;
 }
 
+void bst_iter_init(bst_iter_t *iter, const bst_t *bst, const char *from, const char *to){
+	iter->current = from ? bst_node_first_from(bst, from) : bst_node_first(bst->root);
+	iter->cmp = bst->cmp;
+	iter->end = to;
+	bst_iter_check_end(iter);
+}
+
 bool bst_iter_next(bst_iter_t *iter){
-	if(stack_is_empty(iter->nodes)){
+	if(!iter->current){
 		return false;
 	}
 
-	bst_node_t* poped = stack_pop(iter->nodes);
-	
-	if(poped->right){
-		return stack_left(iter->nodes,poped->right);
-	}
-	
+	iter->current = bst_node_next(iter->current);
+	bst_iter_check_end(iter);
 	return true;
 }
 
 const char *bst_iter_get_current(const bst_iter_t *iter){
-	bst_node_t* current = stack_top(iter->nodes);
-	
-	if(!current) {
+	if(!iter->current) {
 		return NULL;
 	}
 
-	return current->key;
+	return iter->current->key;
 }
 
 bool bst_iter_at_end(const bst_iter_t *iter){
-	return stack_is_empty(iter->nodes);
+	return iter->current == NULL;
 }
 
 void bst_iter_destroy(bst_iter_t* iter){
-	stack_destroy(iter->nodes);
 	free(iter);
 }
\ No newline at end of file
@@ -5,7 +5,12 @@
 
 /*
 Binary Search Tree.
-(needs the stack to work).
+It is kept balanced (AVL), so storing, removing and searching take
+O(log n) time even when keys are stored in order, and they do not use
+recursion.
+Every node knows its parent, so iterators only keep the current node and
+need no memory of their own.
+(needs POSIX threads to work, for building a bst in parallel).
 */
 
 /*******************************************************************
@@ -17,6 +22,15 @@ typedef int (*bst_compare_key_t) (const char *, const char *); //Comparison func
 typedef void (*bst_destroy_data_t) (void *); // Destructor
 typedef struct bst_iter bst_iter_t; //Outer iterator
 
+/*The outer iterator can also be declared as a local variable (and started
+with bst_iter_init), so its fields are visible here, but they should not
+be used directly.*/
+struct bst_iter {
+	const struct bst_node* current;
+	bst_compare_key_t cmp;
+	const char* end;
+};
+
 /*******************************************************************
  * Primitives				
  ******************************************************************/
@@ -24,6 +38,27 @@ typedef struct bst_iter bst_iter_t; //Outer iterator
 /*Creates a new empty bst.*/
 bst_t* bst_create(bst_compare_key_t cmp, bst_destroy_data_t destroy_data);
 
+/*Creates a new empty bst whose nodes and keys are taken from big blocks of
+memory instead of being allocated one by one. Removed nodes are used again
+by later insertions, and all the memory is freed at once by bst_destroy
+(which, without 'destroy_data', does not go through the nodes).*/
+bst_t* bst_create_with_arena(bst_compare_key_t cmp, bst_destroy_data_t destroy_data);
+
+/*Creates a bst with the 'n' keys, which must be in increasing order
+(without repetitions), and their data ('values[i]' for 'keys[i]', or NULL
+if 'values' is NULL). The tree is built in O(n) time, perfectly balanced,
+with every node and key in a single block of memory, and then works like
+one created with bst_create_with_arena.
+Returns NULL if the keys are not in order or in the case of an error.*/
+bst_t* bst_create_from_sorted(bst_compare_key_t cmp, bst_destroy_data_t destroy_data,
+                              const char* const* keys, void* const* values, size_t n);
+
+/*Like bst_create_from_sorted, but splitting the work among 'threads'
+threads (at most 64).*/
+bst_t* bst_create_from_sorted_parallel(bst_compare_key_t cmp, bst_destroy_data_t destroy_data,
+                                       const char* const* keys, void* const* values, size_t n,
+                                       size_t threads);
+
 /* Stores a new element in the bst.
 If the specified key is already in use, it is replaced.
 Returns false in the case of an error.*/
@@ -41,6 +76,14 @@ bool bst_contains(const bst_t *bst, const char *key);
 /*Returns the number of elements in the bst.*/
 size_t bst_size(bst_t *bst);
 
+/*Returns the key in position 'k' (starting from 0) of the keys in order,
+or NULL if there are not more than 'k' keys. Takes O(log n) time.*/
+const char *bst_select(const bst_t *bst, size_t k);
+
+/*Returns the number of keys less than the given one (which does not need
+to be in the bst). Takes O(log n) time.*/
+size_t bst_rank(const bst_t *bst, const char *key);
+
 /* Destroys the bst, applying to every element of the
 bst the specified destroying function */
 void bst_destroy(bst_t *bst);
@@ -52,11 +95,32 @@ while that function returns true. If 'extra' argument is specified
 (not NULL), the result of the iteration is saved on it.*/
 void bst_visit(bst_t *bst, bool visit(const char *, void *, void *), void *extra);
 
+/* Like bst_visit, but only for the keys from 'from' (included) to 'to'
+(not included), in order. If 'from' is NULL, it starts at the first key,
+and if 'to' is NULL, it goes up to the last one. It only goes through the
+keys it visits and the path to the first one.*/
+void bst_visit_range(bst_t *bst, const char *from, const char *to,
+                     bool visit(const char *, void *, void *), void *extra);
+
 /*Outer iterator*/
 
 /* Creates a new iterator*/
 bst_iter_t *bst_iter_create(const bst_t *bst);
 
+/* Creates a new iterator, which starts at the first key that is not less
+than 'from' (the end if there is none).*/
+bst_iter_t *bst_iter_create_from(const bst_t *bst, const char *from);
+
+/* Creates a new iterator that goes through the keys from 'from'
+(included) to 'to' (not included). Either of them can be NULL, to start at
+the first key or to go up to the last one. 'to' is copied.*/
+bst_iter_t *bst_iter_create_range(const bst_t *bst, const char *from, const char *to);
+
+/* Starts an iterator declared by the caller, like bst_iter_create_range
+but without allocating anything ('to' is not copied, so it must not change
+while iterating). It does not need to be destroyed.*/
+void bst_iter_init(bst_iter_t *iter, const bst_t *bst, const char *from, const char *to);
+
 /* Moves the iterator to the next element in the bst.
 Returns false if moving forward is not possible.*/
 bool bst_iter_next(bst_iter_t *iter);
@@ -68,7 +132,7 @@ const char *bst_iter_get_current(const bst_iter_t *iter);
 cannot move any further).*/
 bool bst_iter_at_end(const bst_iter_t *iter);
 
-/*Destroys the iterator.*/
+/*Destroys an iterator created by one of the bst_iter_create functions.*/
 void bst_iter_destroy(bst_iter_t* iter);
 
 #endif // BST_H
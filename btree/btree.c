@@ -0,0 +1,614 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "btree.h"
+
+#define DEGREE 8
+#define MAX_KEYS (2 * DEGREE - 1)
+#define MIN_KEYS (DEGREE - 1)
+#define PREFIX_SIZE 8
+
+/*******************************************************************
+ * Structures
+ ******************************************************************/
+
+/*Node with 'count' keys (between MIN_KEYS and MAX_KEYS, except the root),
+in order. 'prefixes' has the first PREFIX_SIZE bytes of each key as a big
+endian number (with zeros after the end of the key), so comparing two
+prefixes gives the same order as strcmp.
+Internal nodes also have 'count' + 1 children: the keys of children[i]
+go between keys[i - 1] and keys[i]. Leaves are allocated without room for
+the children.*/
+typedef struct bst_node{
+	uint64_t prefixes[MAX_KEYS];
+	char* keys[MAX_KEYS];
+	void* data[MAX_KEYS];
+	size_t count;
+	bool leaf;
+	struct bst_node* children[];
+}bst_node_t;
+
+/*'by_prefix' is true when the keys are compared with strcmp, so their
+prefixes can be compared instead.
+The height of the tree is at most log_DEGREE(n), far below BST_MAX_DEPTH.*/
+struct bst{
+	bst_node_t* root;
+	bst_compare_key_t cmp;
+	bst_destroy_data_t destroy_data;
+	size_t items;
+	bool by_prefix;
+};
+
+/*******************************************************************
+ * Auxiliary Functions
+ ******************************************************************/
+
+/*Returns the prefix of the key (see bst_node_t).*/
+uint64_t bst_prefix(const char* key){
+	uint64_t prefix = 0;
+	size_t i = 0;
+
+	for(; i < PREFIX_SIZE && key[i]; i++){
+		prefix = (prefix << 8) | (unsigned char)key[i];
+	}
+
+	return i == PREFIX_SIZE ? prefix : prefix << (8 * (PREFIX_SIZE - i));
+}
+
+/*Compares the key (whose prefix is 'prefix') with the key in position
+'pos' of the node.*/
+int bst_compare(const bst_t* bst, const char* key, uint64_t prefix, const bst_node_t* node, size_t pos){
+	if(!bst->by_prefix){
+		return bst->cmp(key, node->keys[pos]);
+	}
+
+	if(prefix != node->prefixes[pos]){
+		return prefix < node->prefixes[pos] ? -1 : 1;
+	}
+
+	/*Keys shorter than the prefix end with a zero byte in it.*/
+	if((prefix & 0xFF) == 0){
+		return 0;
+	}
+
+	return strcmp(key + PREFIX_SIZE, node->keys[pos] + PREFIX_SIZE);
+}
+
+/*Searches the key in the node. Saves in 'pos' its position or, if it is
+not there, the position of the first greater key (which is also the child
+where it has to be searched). Returns true if it was found.*/
+bool bst_node_find(const bst_t* bst, const bst_node_t* node, const char* key, uint64_t prefix, size_t* pos){
+	size_t low = 0;
+	size_t high = node->count;
+
+	while(low < high){
+		size_t middle = (low + high) / 2;
+		int comparison = bst_compare(bst, key, prefix, node, middle);
+
+		if(comparison == 0){
+			*pos = middle;
+			return true;
+		}
+
+		if(comparison < 0){
+			high = middle;
+		}
+
+		else{
+			low = middle + 1;
+		}
+	}
+
+	*pos = low;
+	return false;
+}
+
+/*Creates a new empty node.*/
+bst_node_t* bst_node_create(bool leaf){
+	size_t size = sizeof(bst_node_t);
+
+	if(!leaf){
+		size += sizeof(bst_node_t*) * (MAX_KEYS + 1);
+	}
+
+	bst_node_t* node = malloc(size);
+
+	if(!node){
+		return NULL;
+	}
+
+	node->count = 0;
+	node->leaf = leaf;
+	return node;
+}
+
+/*Moves 'count' keys (with their prefixes and data) from position 'from'
+of 'source' to position 'to' of 'destination'.*/
+void bst_node_move_keys(bst_node_t* destination, size_t to, bst_node_t* source, size_t from, size_t count){
+	memmove(&destination->prefixes[to], &source->prefixes[from], sizeof(uint64_t) * count);
+	memmove(&destination->keys[to], &source->keys[from], sizeof(char*) * count);
+	memmove(&destination->data[to], &source->data[from], sizeof(void*) * count);
+}
+
+/*Moves 'count' children from position 'from' of 'source' to position 'to'
+of 'destination'.*/
+void bst_node_move_children(bst_node_t* destination, size_t to, bst_node_t* source, size_t from, size_t count){
+	memmove(&destination->children[to], &source->children[from], sizeof(bst_node_t*) * count);
+}
+
+/*Splits the full child 'pos' of the node in two, moving its middle key up
+to the node (in position 'pos'). Returns false in the case of an error.*/
+bool bst_node_split_child(bst_node_t* node, size_t pos){
+	bst_node_t* left = node->children[pos];
+	bst_node_t* right = bst_node_create(left->leaf);
+
+	if(!right){
+		return false;
+	}
+
+	bst_node_move_keys(right, 0, left, DEGREE, MAX_KEYS - DEGREE);
+
+	if(!left->leaf){
+		bst_node_move_children(right, 0, left, DEGREE, DEGREE);
+	}
+
+	right->count = MAX_KEYS - DEGREE;
+	left->count = DEGREE - 1;
+	bst_node_move_keys(node, pos + 1, node, pos, node->count - pos);
+	bst_node_move_children(node, pos + 2, node, pos + 1, node->count - pos);
+	bst_node_move_keys(node, pos, left, DEGREE - 1, 1);
+	node->children[pos + 1] = right;
+	node->count++;
+	return true;
+}
+
+/*Joins the children 'pos' and 'pos' + 1 of the node, with the key 'pos'
+between them (the resulting node has at most MAX_KEYS keys).*/
+void bst_node_merge_children(bst_node_t* node, size_t pos){
+	bst_node_t* left = node->children[pos];
+	bst_node_t* right = node->children[pos + 1];
+	bst_node_move_keys(left, left->count, node, pos, 1);
+	bst_node_move_keys(left, left->count + 1, right, 0, right->count);
+
+	if(!left->leaf){
+		bst_node_move_children(left, left->count + 1, right, 0, right->count + 1);
+	}
+
+	left->count += right->count + 1;
+	free(right);
+	bst_node_move_keys(node, pos, node, pos + 1, node->count - pos - 1);
+	bst_node_move_children(node, pos + 1, node, pos + 2, node->count - pos - 1);
+	node->count--;
+}
+
+/*Gives to the child 'pos' of the node (which has less than MIN_KEYS keys)
+a key of one of its siblings, or merges it with one of them.*/
+void bst_node_fix_child(bst_node_t* node, size_t pos){
+	bst_node_t* child = node->children[pos];
+	bst_node_t* left = pos > 0 ? node->children[pos - 1] : NULL;
+	bst_node_t* right = pos < node->count ? node->children[pos + 1] : NULL;
+
+	if(left && left->count > MIN_KEYS){
+		bst_node_move_keys(child, 1, child, 0, child->count);
+		bst_node_move_keys(child, 0, node, pos - 1, 1);
+		bst_node_move_keys(node, pos - 1, left, left->count - 1, 1);
+
+		if(!child->leaf){
+			bst_node_move_children(child, 1, child, 0, child->count + 1);
+			child->children[0] = left->children[left->count];
+		}
+
+		child->count++;
+		left->count--;
+	}
+
+	else if(right && right->count > MIN_KEYS){
+		bst_node_move_keys(child, child->count, node, pos, 1);
+		bst_node_move_keys(node, pos, right, 0, 1);
+		bst_node_move_keys(right, 0, right, 1, right->count - 1);
+
+		if(!child->leaf){
+			child->children[child->count + 1] = right->children[0];
+			bst_node_move_children(right, 0, right, 1, right->count);
+		}
+
+		child->count++;
+		right->count--;
+	}
+
+	else if(left){
+		bst_node_merge_children(node, pos - 1);
+	}
+
+	else{
+		bst_node_merge_children(node, pos);
+	}
+}
+
+/*Searches for the key. Returns the node that holds it (and saves its
+position in 'pos'), or NULL if it is not in the bst.*/
+bst_node_t* bst_node_search(const bst_t* bst, const char* key, size_t* pos){
+	uint64_t prefix = bst_prefix(key);
+	bst_node_t* node = bst->root;
+
+	while(node){
+		if(bst_node_find(bst, node, key, prefix, pos)){
+			return node;
+		}
+
+		node = node->leaf ? NULL : node->children[*pos];
+	}
+
+	return NULL;
+}
+
+/*Moves the iterator down to the first key of the subtree.*/
+void bst_iter_push_left(bst_iter_t* iter, bst_node_t* node){
+	while(true){
+		iter->nodes[iter->depth] = node;
+		iter->positions[iter->depth] = 0;
+		iter->depth++;
+
+		if(node->leaf){
+			break;
+		}
+
+		node = node->children[0];
+	}
+
+	/*Only an empty root has no keys.*/
+	if(node->count == 0){
+		iter->depth = 0;
+	}
+}
+
+/*Removes from the iterator's path the nodes that have no keys left.*/
+void bst_iter_pop_done(bst_iter_t* iter){
+	while(iter->depth > 0 && iter->positions[iter->depth - 1] == iter->nodes[iter->depth - 1]->count){
+		iter->depth--;
+	}
+}
+
+/*Moves the iterator down to the first key that is not less than 'from'.*/
+void bst_iter_seek(bst_iter_t* iter, const bst_t* bst, const char* from){
+	uint64_t prefix = bst_prefix(from);
+	bst_node_t* node = bst->root;
+
+	while(true){
+		size_t pos;
+		bool found = bst_node_find(bst, node, from, prefix, &pos);
+		iter->nodes[iter->depth] = node;
+		iter->positions[iter->depth++] = pos;
+
+		if(found || node->leaf){
+			break;
+		}
+
+		node = node->children[pos];
+	}
+
+	/*Nodes where every key is less than 'from' have nothing left.*/
+	bst_iter_pop_done(iter);
+}
+
+/*Moves the iterator to the key after the current one.*/
+void bst_iter_advance(bst_iter_t* iter){
+	bst_node_t* node = iter->nodes[iter->depth - 1];
+	size_t pos = ++iter->positions[iter->depth - 1];
+
+	if(!node->leaf){
+		bst_iter_push_left(iter, node->children[pos]);
+	}
+
+	bst_iter_pop_done(iter);
+}
+
+/*Moves the iterator to the end if its current key is not before its end.*/
+void bst_iter_check_end(bst_iter_t* iter){
+	if(iter->end && iter->depth > 0 && iter->cmp(bst_iter_get_current(iter), iter->end) >= 0){
+		iter->depth = 0;
+	}
+}
+
+/*******************************************************************
+ * Primitives
+ ******************************************************************/
+
+/*bst*/
+
+bst_t* bst_create(bst_compare_key_t cmp, bst_destroy_data_t destroy_data){
+	bst_t* bst = malloc(sizeof(bst_t));
+
+	if(!bst) {
+		return NULL;
+	}
+
+	bst->root = bst_node_create(true);
+
+	if(!bst->root) {
+		free(bst);
+		return NULL;
+	}
+
+	bst->cmp = cmp ? cmp : strcmp;
+	bst->by_prefix = bst->cmp == strcmp;
+	bst->destroy_data = destroy_data;
+	bst->items = 0;
+	return bst;
+}
+
+bool bst_store(bst_t *bst, const char *key, void *data){
+	if(bst->root->count == MAX_KEYS){
+		bst_node_t* root = bst_node_create(false);
+
+		if(!root){
+			return false;
+		}
+
+		root->children[0] = bst->root;
+
+		if(!bst_node_split_child(root, 0)){
+			free(root);
+			return false;
+		}
+
+		bst->root = root;
+	}
+
+	/*Full nodes are split on the way down, so there is always room for
+	the key that goes up from a split.*/
+	uint64_t prefix = bst_prefix(key);
+	bst_node_t* node = bst->root;
+	size_t pos;
+
+	while(!bst_node_find(bst, node, key, prefix, &pos)){
+		if(node->leaf){
+			char* copy = malloc(strlen(key) + 1); //\0
+
+			if(!copy){
+				return false;
+			}
+
+			strcpy(copy, key);
+			bst_node_move_keys(node, pos + 1, node, pos, node->count - pos);
+			node->prefixes[pos] = prefix;
+			node->keys[pos] = copy;
+			node->data[pos] = data;
+			node->count++;
+			bst->items++;
+			return true;
+		}
+
+		if(node->children[pos]->count == MAX_KEYS){
+			if(!bst_node_split_child(node, pos)){
+				return false;
+			}
+
+			int comparison = bst_compare(bst, key, prefix, node, pos);
+
+			if(comparison == 0){
+				break;
+			}
+
+			if(comparison > 0){
+				pos++;
+			}
+		}
+
+		node = node->children[pos];
+	}
+
+	void* old_data = node->data[pos];
+	node->data[pos] = data;
+
+	if(bst->destroy_data) {
+		bst->destroy_data(old_data);
+	}
+
+	return true;
+}
+
+void *bst_remove(bst_t *bst, const char *key){
+	bst_node_t* nodes[BST_MAX_DEPTH];
+	size_t positions[BST_MAX_DEPTH];
+	size_t depth = 0;
+	uint64_t prefix = bst_prefix(key);
+	bst_node_t* node = bst->root;
+	size_t pos;
+
+	while(!bst_node_find(bst, node, key, prefix, &pos)){
+		if(node->leaf){
+			return NULL;
+		}
+
+		nodes[depth] = node;
+		positions[depth++] = pos;
+		node = node->children[pos];
+	}
+
+	void* data = node->data[pos];
+	free(node->keys[pos]);
+
+	if(node->leaf){
+		bst_node_move_keys(node, pos, node, pos + 1, node->count - pos - 1);
+	}
+
+	else{
+		/*The key is replaced by the previous one, which is always in a
+		leaf.*/
+		bst_node_t* leaf = node->children[pos];
+		nodes[depth] = node;
+		positions[depth++] = pos;
+
+		while(!leaf->leaf){
+			nodes[depth] = leaf;
+			positions[depth++] = leaf->count;
+			leaf = leaf->children[leaf->count];
+		}
+
+		bst_node_move_keys(node, pos, leaf, leaf->count - 1, 1);
+		node = leaf;
+	}
+
+	node->count--;
+
+	while(depth > 0 && node->count < MIN_KEYS){
+		depth--;
+		bst_node_fix_child(nodes[depth], positions[depth]);
+		node = nodes[depth];
+	}
+
+	if(bst->root->count == 0 && !bst->root->leaf){
+		bst_node_t* root = bst->root;
+		bst->root = root->children[0];
+		free(root);
+	}
+
+	bst->items--;
+	return data;
+}
+
+void *bst_get(const bst_t *bst, const char *key){
+	size_t pos;
+	bst_node_t* node = bst_node_search(bst, key, &pos);
+
+	if(!node) {
+		return NULL;
+	}
+
+	return node->data[pos];
+}
+
+bool bst_contains(const bst_t *bst, const char *key){
+	size_t pos;
+	return bst_node_search(bst, key, &pos) != NULL;
+}
+
+size_t bst_size(bst_t *bst){
+	return bst->items;
+}
+
+void bst_destroy(bst_t *bst){
+	bst_node_t* nodes[BST_MAX_DEPTH];
+	size_t positions[BST_MAX_DEPTH];
+	size_t depth = 1;
+	nodes[0] = bst->root;
+	positions[0] = 0;
+
+	/*Every node is freed after its children.*/
+	while(depth > 0){
+		bst_node_t* node = nodes[depth - 1];
+
+		if(!node->leaf && positions[depth - 1] <= node->count){
+			nodes[depth] = node->children[positions[depth - 1]++];
+			positions[depth++] = 0;
+			continue;
+		}
+
+		for(size_t i = 0; i < node->count; i++){
+			if(bst->destroy_data){
+				bst->destroy_data(node->data[i]);
+			}
+
+			free(node->keys[i]);
+		}
+
+		free(node);
+		depth--;
+	}
+
+	free(bst);
+}
+
+/*Inner Iterator*/
+
+void bst_visit(bst_t *bst, bool visit(const char *, void *, void *), void *extra){
+	bst_visit_range(bst, NULL, NULL, visit, extra);
+}
+
+void bst_visit_range(bst_t *bst, const char *from, const char *to,
+                     bool visit(const char *, void *, void *), void *extra){
+	bst_iter_t iter;
+	bst_iter_init(&iter, bst, from, to);
+
+	while(iter.depth > 0){
+		bst_node_t* node = iter.nodes[iter.depth - 1];
+		size_t pos = iter.positions[iter.depth - 1];
+
+		if(!visit(node->keys[pos], node->data[pos], extra)){
+			return;
+		}
+
+		bst_iter_next(&iter);
+	}
+}
+
+/*Outer iterator*/
+
+bst_iter_t *bst_iter_create(const bst_t *bst){
+	return bst_iter_create_range(bst, NULL, NULL);
+}
+
+bst_iter_t *bst_iter_create_from(const bst_t *bst, const char *from){
+	return bst_iter_create_range(bst, from, NULL);
+}
+
+bst_iter_t *bst_iter_create_range(const bst_t *bst, const char *from, const char *to){
+	/*The copy of 'to' goes right after the iterator.*/
+	size_t end_size = to ? strlen(to) + 1 : 0; //\0
+	bst_iter_t* iter = malloc(sizeof(bst_iter_t) + end_size);
+
+	if(!iter) {
+		return NULL;
+	}
+
+	if(to){
+		to = memcpy(iter + 1, to, end_size);
+	}
+
+	bst_iter_init(iter, bst, from, to);
+	return iter;
+}
+
+void bst_iter_init(bst_iter_t *iter, const bst_t *bst, const char *from, const char *to){
+	iter->depth = 0;
+	iter->cmp = bst->cmp;
+	iter->end = to;
+
+	if(from){
+		bst_iter_seek(iter, bst, from);
+	}
+
+	else{
+		bst_iter_push_left(iter, bst->root);
+	}
+
+	bst_iter_check_end(iter);
+}
+
+bool bst_iter_next(bst_iter_t *iter){
+	if(bst_iter_at_end(iter)){
+		return false;
+	}
+
+	bst_iter_advance(iter);
+	bst_iter_check_end(iter);
+	return true;
+}
+
+const char *bst_iter_get_current(const bst_iter_t *iter){
+	if(bst_iter_at_end(iter)) {
+		return NULL;
+	}
+
+	return iter->nodes[iter->depth - 1]->keys[iter->positions[iter->depth - 1]];
+}
+
+bool bst_iter_at_end(const bst_iter_t *iter){
+	return iter->depth == 0;
+}
+
+void bst_iter_destroy(bst_iter_t* iter){
+	free(iter);
+}
@@ -0,0 +1,118 @@
+#ifndef BST_H
+#define BST_H
+#include <stdbool.h>
+#include <string.h>
+
+/*
+Ordered map with the same interface as the binary search tree, stored as
+a B-tree: every node holds several keys, so a search goes through a few
+nodes instead of one node per level.
+Each node keeps the first 8 bytes of its keys together, in one array, and
+searches it with binary search. When the keys are compared with strcmp (or
+NULL is given as comparison function), most comparisons only read that
+array, and the rest of a key is read only when the first 8 bytes match.
+*/
+
+/*******************************************************************
+ * Structures
+ ******************************************************************/
+
+typedef struct bst bst_t;
+typedef int (*bst_compare_key_t) (const char *, const char *); //Comparison function
+typedef void (*bst_destroy_data_t) (void *); // Destructor
+typedef struct bst_iter bst_iter_t; //Outer iterator
+
+/*Maximum height of the tree (far more than it can reach).*/
+#define BST_MAX_DEPTH 32
+
+/*The outer iterator can also be declared as a local variable (and started
+with bst_iter_init), so its fields are visible here, but they should not
+be used directly. It keeps the path from the root to the current key: the
+current key is keys[positions[depth - 1]] of nodes[depth - 1], and each
+node above it is waiting to continue with its key positions[i], after the
+child before that key.*/
+struct bst_iter {
+	struct bst_node* nodes[BST_MAX_DEPTH];
+	size_t positions[BST_MAX_DEPTH];
+	size_t depth;
+	bst_compare_key_t cmp;
+	const char* end;
+};
+
+/*******************************************************************
+ * Primitives
+ ******************************************************************/
+
+/*Creates a new empty bst. If 'cmp' is NULL, keys are compared with
+strcmp.*/
+bst_t* bst_create(bst_compare_key_t cmp, bst_destroy_data_t destroy_data);
+
+/* Stores a new element in the bst.
+If the specified key is already in use, it is replaced.
+Returns false in the case of an error.*/
+bool bst_store(bst_t *bst, const char *key, void *data);
+
+/* Removes an element from the bst, and returns its data.*/
+void *bst_remove(bst_t *bst, const char *key);
+
+/*Returns the data associated with the given key.*/
+void *bst_get(const bst_t *bst, const char *key);
+
+/*Returns true if the key exists in the bst. */
+bool bst_contains(const bst_t *bst, const char *key);
+
+/*Returns the number of elements in the bst.*/
+size_t bst_size(bst_t *bst);
+
+/* Destroys the bst, applying to every element of the
+bst the specified destroying function */
+void bst_destroy(bst_t *bst);
+
+/*Inner iterator*/
+
+/* Applies the function 'visit' to every element in the bst (in order),
+while that function returns true. If 'extra' argument is specified
+(not NULL), the result of the iteration is saved on it.*/
+void bst_visit(bst_t *bst, bool visit(const char *, void *, void *), void *extra);
+
+/* Like bst_visit, but only for the keys from 'from' (included) to 'to'
+(not included), in order. If 'from' is NULL, it starts at the first key,
+and if 'to' is NULL, it goes up to the last one. It only goes through the
+keys it visits and the path to the first one.*/
+void bst_visit_range(bst_t *bst, const char *from, const char *to,
+                     bool visit(const char *, void *, void *), void *extra);
+
+/*Outer iterator*/
+
+/* Creates a new iterator, which goes through the keys in order.*/
+bst_iter_t *bst_iter_create(const bst_t *bst);
+
+/* Creates a new iterator, which starts at the first key that is not less
+than 'from' (the end if there is none).*/
+bst_iter_t *bst_iter_create_from(const bst_t *bst, const char *from);
+
+/* Creates a new iterator that goes through the keys from 'from'
+(included) to 'to' (not included). Either of them can be NULL, to start at
+the first key or to go up to the last one. 'to' is copied.*/
+bst_iter_t *bst_iter_create_range(const bst_t *bst, const char *from, const char *to);
+
+/* Starts an iterator declared by the caller, like bst_iter_create_range
+but without allocating anything ('to' is not copied, so it must not change
+while iterating). It does not need to be destroyed.*/
+void bst_iter_init(bst_iter_t *iter, const bst_t *bst, const char *from, const char *to);
+
+/* Moves the iterator to the next element in the bst.
+Returns false if moving forward is not possible.*/
+bool bst_iter_next(bst_iter_t *iter);
+
+/* Returns the key associated with iterator's current element.*/
+const char *bst_iter_get_current(const bst_iter_t *iter);
+
+/* Returns true if the iterator is at the end of the bst (it
+cannot move any further).*/
+bool bst_iter_at_end(const bst_iter_t *iter);
+
+/*Destroys an iterator created by one of the bst_iter_create functions.*/
+void bst_iter_destroy(bst_iter_t* iter);
+
+#endif // BST_H
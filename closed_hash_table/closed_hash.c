@@ -1,30 +1,75 @@
 #include "closed_hash.h"
+#include "hash_function.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 
-#define CAPACITY 97
+#define CAPACITY 128
 #define PERCENT 100
 #define MAX_LOAD 70
 #define MIN_LOAD 15
+#define MAX_LOAD_LIMIT 95
+#define MIGRATION_STEP 8
+#define MIN_LOAD_GAP 10
+#define INLINE_KEY_SIZE 24
+#define BATCH_SIZE 16
+
+#ifdef __GNUC__
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address)
+#endif
 
 /*******************************************************************
  *Structures				
  ******************************************************************/
 
+/*REMOVED is only used in the array being migrated: removing from the
+current array shifts back the following elements instead.*/
 typedef enum {EMPTY, REMOVED, OCCUPIED} state_t;
 
+/*The full hash and the length of the key are kept in the node, so probes
+can discard most mismatches without reading the key itself.
+Keys are sequences of bytes, stored with a '\0' after them (so string keys
+can be returned as they are). Keys shorter than INLINE_KEY_SIZE (counting
+the '\0') are stored in the node itself, as integer keys always are; only
+longer ones are allocated separately.*/
 typedef struct hash_node{
-	char* key;
+	uint64_t hash;
 	void* value;
+	union{
+		char* pointer;
+		char buffer[INLINE_KEY_SIZE];
+	}key;
+	uint32_t length;
 	state_t state;
 }hash_node_t;
 
+/*The table grows when its load (percentage of used slots) reaches
+'max_load', and shrinks when it falls to 'min_load', but never below
+'min_size' slots.
+While the table is being resized, the previous array ('old_array') is
+kept alongside the new one and its slots are moved into 'array' a few at
+a time, starting from an empty slot ('migration_start'). The first
+'migrated' slots of that walk are already empty. Every store and removal
+moves 'migration_step' slots, enough to finish before the number of
+elements can reach either load limit of the new array.*/
 struct hash{
 	hash_node_t* array;
 	size_t items;
 	size_t size;
+	hash_node_t* old_array;
+	size_t old_size;
+	size_t migration_start;
+	size_t migrated;
+	size_t migration_step;
+	hash_function_t hash_function;
+	hash_key_equal_t key_equal;
 	hash_destroy_data_t destroy;
+	size_t max_load;
+	size_t min_load;
+	size_t min_size;
 };
 
 struct hash_iter{
@@ -36,25 +81,213 @@ struct hash_iter{
  *Auxiliary Functions				
  ******************************************************************/
 
-/*Bernstein's hashing function. 
-Based on the generic multiplicative function from: 
-https://www.strchr.com/hash_functions */
-size_t hashing(const char *str, size_t capacity){
-    int nhash = 5381;
-    int c;
+/*Returns the key stored in the node.*/
+const char* hash_node_key(const hash_node_t* node){
+	if(node->length < INLINE_KEY_SIZE){
+		return node->key.buffer;
+	}
+
+	return node->key.pointer;
+}
+
+/*Copies the key into the node. Returns false in the case of an error.*/
+bool hash_node_set_key(hash_node_t* node, const void* key, size_t length){
+	char* copy = node->key.buffer;
+
+	if(length >= INLINE_KEY_SIZE){
+		copy = malloc(length + 1);
+
+		if(!copy){
+			return false;
+		}
+
+		node->key.pointer = copy;
+	}
+
+	memcpy(copy, key, length);
+	copy[length] = '\0';
+	node->length = (uint32_t)length;
+	return true;
+}
+
+/*Releases the key of the node, if it was allocated.*/
+void hash_node_free_key(hash_node_t* node){
+	if(node->length >= INLINE_KEY_SIZE){
+		free(node->key.pointer);
+	}
+}
+
+/*Returns true if the node holds the given key (compared with the
+equality function of the table, if it has one).*/
+bool hash_node_matches(const hash_t* hash, const hash_node_t* node, uint64_t key_hash, const void* key, size_t length){
+	if(node->state != OCCUPIED || node->hash != key_hash || node->length != length){
+		return false;
+	}
+
+	if(hash->key_equal){
+		return hash->key_equal(hash_node_key(node), key, length);
+	}
+
+	return memcmp(hash_node_key(node), key, length) == 0;
+}
+
+/*Probes the array being migrated from the given position. Returns the
+position where the key is stored or, if it is not there, the first empty
+position found.*/
+size_t hash_probe(const hash_t* hash, const hash_node_t* array, size_t size, size_t pos, uint64_t key_hash, const void* key, size_t length){
+	while(array[pos].state != EMPTY){
+		if(hash_node_matches(hash, &array[pos], key_hash, key, length)){
+			break;
+		}
+
+		pos++;
+
+		if(pos == size){
+			pos = 0;
+		}
+	}
+
+	return pos;
+}
+
+/*Returns the position of the key in the array being migrated (see
+hash_probe). Probe sequences that start on an already migrated slot
+continue from the first one that has not been migrated yet.*/
+size_t hash_old_probe(const hash_t* hash, uint64_t key_hash, const void* key, size_t length){
+	size_t pos = key_hash & (hash->old_size - 1);
+	size_t distance = (pos - hash->migration_start) & (hash->old_size - 1);
+
+	if(distance < hash->migrated){
+		pos = (hash->migration_start + hash->migrated) & (hash->old_size - 1);
+	}
 
-    while ((c = *str++)){
-        nhash = ((nhash << 5) + nhash) + c; /* hash * 33 + c */
-    }
+	return hash_probe(hash, hash->old_array, hash->old_size, pos, key_hash, key, length);
+}
+
+/*Returns how far the element in the given position of the current array
+is from the position its hash points to.*/
+size_t hash_distance(const hash_t* hash, size_t pos){
+	return (pos - hash->array[pos].hash) & (hash->size - 1);
+}
+
+/*Returns the position of the key in the current array, or hash->size if
+it is not there.
+Elements are kept in Robin Hood order (see hash_insert), so the search
+stops as soon as it reaches an element closer to its own position than
+the searched key would be.*/
+size_t hash_find(const hash_t* hash, uint64_t key_hash, const void* key, size_t length){
+	size_t mask = hash->size - 1;
+	size_t pos = key_hash & mask;
+	size_t distance = 0;
+
+	while(hash->array[pos].state == OCCUPIED && hash_distance(hash, pos) >= distance){
+		if(hash_node_matches(hash, &hash->array[pos], key_hash, key, length)){
+			return pos;
+		}
+
+		pos = (pos + 1) & mask;
+		distance++;
+	}
+
+	return hash->size;
+}
+
+/*Inserts a node (whose key is not in the current array) using Robin Hood
+hashing: while probing, the node takes the place of any element that is
+closer to its own position, and that element continues probing instead.*/
+void hash_insert(hash_t* hash, hash_node_t node){
+	size_t mask = hash->size - 1;
+	size_t pos = node.hash & mask;
+	size_t distance = 0;
+
+	while(hash->array[pos].state == OCCUPIED){
+		size_t other_distance = hash_distance(hash, pos);
+
+		if(other_distance < distance){
+			hash_node_t aux = hash->array[pos];
+			hash->array[pos] = node;
+			node = aux;
+			distance = other_distance;
+		}
+
+		pos = (pos + 1) & mask;
+		distance++;
+	}
+
+	hash->array[pos] = node;
+}
+
+/*Empties the given position of the current array, moving back one
+position the following elements of the cluster (so no removed slots
+are left behind and the Robin Hood order is kept).*/
+void hash_shift_back(hash_t* hash, size_t pos){
+	size_t mask = hash->size - 1;
+	size_t next = (pos + 1) & mask;
+
+	while(hash->array[next].state == OCCUPIED && hash_distance(hash, next) > 0){
+		hash->array[pos] = hash->array[next];
+		pos = next;
+		next = (next + 1) & mask;
+	}
+
+	hash->array[pos].state = EMPTY;
+}
+
+/*Moves up to 'steps' slots from the old array to the current one.
+The old array is released once every slot has been moved.*/
+void hash_migrate(hash_t* hash, size_t steps){
+	while(hash->old_array && steps > 0){
+		size_t pos = (hash->migration_start + hash->migrated) & (hash->old_size - 1);
+		hash_node_t* node = &hash->old_array[pos];
+
+		if(node->state == OCCUPIED){
+			hash_insert(hash, *node);
+		}
+
+		node->state = EMPTY;
+		hash->migrated++;
+		steps--;
+
+		if(hash->migrated == hash->old_size){
+			free(hash->old_array);
+			hash->old_array = NULL;
+			hash->old_size = 0;
+		}
+	}
+}
 
-    return (nhash % capacity);
+/*Allocates an array of empty nodes. EMPTY is 0, so zeroed memory is
+enough (and the system usually gives it without touching every slot).*/
+hash_node_t* hash_array_create(size_t capacity){
+	return calloc(capacity, sizeof(hash_node_t));
 }
 
-/*Recreates the hash table, resizing it.*/
+/*Returns the number of slots each store or removal has to migrate so
+that the migration ends before the table can be resized again: the
+number of elements has to change by at least 'distance' to reach either
+load limit of the current array. Right after a resize the load is half
+(or twice) the limit that triggered it, so MIN_LOAD_GAP keeps 'distance'
+at least 5% of the size of the array, and the step at most about 20 plus
+MIGRATION_STEP slots.*/
+size_t hash_migration_step(const hash_t* hash){
+	size_t grow_at = hash->size * hash->max_load / PERCENT;
+	size_t shrink_at = hash->size * hash->min_load / PERCENT;
+	size_t to_grow = grow_at > hash->items ? grow_at - hash->items : 0;
+	size_t to_shrink = hash->items > shrink_at ? hash->items - shrink_at : 0;
+	size_t distance = to_grow < to_shrink ? to_grow : to_shrink;
+	return MIGRATION_STEP + hash->old_size / (distance > 1 ? distance - 1 : 1);
+}
+
+/*Starts resizing the hash table: a new array is allocated and the elements
+are moved into it by the following operations (see hash_migrate).
+A resize that is still in progress is finished first, which only happens
+if the load factors were changed during the migration.*/
 bool hash_resize(hash_t* hash){
 	size_t new_capacity;
+
+	hash_migrate(hash, hash->old_size);
 	
-	if(MIN_LOAD >= ((float)hash->items / (float)hash->size) * PERCENT){
+	if(hash->min_load >= ((float)hash->items / (float)hash->size) * PERCENT){
 		new_capacity = (hash->size) / 2;
 	}
 	
@@ -62,48 +295,223 @@ bool hash_resize(hash_t* hash){
 		new_capacity = (hash->size) * 2;
 	}
 	
-	size_t pos = 0;
-	hash_node_t* new_array = malloc(sizeof(hash_node_t) * new_capacity);
+	hash_node_t* new_array = hash_array_create(new_capacity);
 	
 	if (new_array == NULL){
 		return false;
 	}
-	
-	hash_node_t* aux = hash->array;
-	hash->items = 0;
+
+	hash->old_array = hash->array;
+	hash->old_size = hash->size;
 	hash->array = new_array;
-	size_t old_capacity = hash->size;
 	hash->size = new_capacity;
+	hash->migrated = 0;
+	hash->migration_start = 0;
+	hash->migration_step = hash_migration_step(hash);
+
+	while(hash->migration_start != hash->old_size - 1 &&
+		  hash->old_array[hash->migration_start].state != EMPTY){
+		hash->migration_start++;
+	}
+
+	return true;
+}
+
+/*Returns the size needed to hold the given number of elements without
+reaching the maximum load.*/
+size_t hash_size_for(const hash_t* hash, size_t count){
+	size_t size = CAPACITY;
+
+	while(count * PERCENT >= size * hash->max_load){
+		size *= 2;
+	}
+
+	return size;
+}
+
+/*Moves every element to a new array of the given capacity at once, after
+finishing any migration in progress. It takes O(n) time, so it is only
+used by the explicit hash_reserve and hash_shrink_to_fit calls; resizes
+caused by stores and removals are spread among the operations.
+Returns false in the case of an error.*/
+bool hash_rehash(hash_t* hash, size_t capacity){
+	hash_node_t* new_array = hash_array_create(capacity);
+
+	if(new_array == NULL){
+		return false;
+	}
+
+	hash_migrate(hash, hash->old_size);
+	hash_node_t* old_array = hash->array;
+	size_t old_size = hash->size;
+	hash->array = new_array;
+	hash->size = capacity;
+
+	for(size_t pos = 0; pos < old_size; pos++){
+		if(old_array[pos].state == OCCUPIED){
+			hash_insert(hash, old_array[pos]);
+		}
+	}
+
+	free(old_array);
+	return true;
+}
+
+/*Stores the data once the hash of the key is known (the load of the table
+is not checked). Returns false in the case of an error, or if the key is
+too long for its length to be saved.*/
+bool hash_store_hashed(hash_t* hash, const void* key, size_t length, uint64_t key_hash, void* data){
+	if(length > UINT32_MAX){
+		return false;
+	}
+
+	size_t pos = hash_find(hash, key_hash, key, length);
 	
-	for (size_t aux_pos = 0; aux_pos<(hash->size); aux_pos++){
-		hash->array[aux_pos].state = EMPTY;
+	if(pos != hash->size){
+		if (hash->destroy){
+			hash->destroy(hash->array[pos].value);
+		}
+
+		hash->array[pos].value = data;
+		return true;
 	}
+		
+	hash_node_t node;
+	node.state = EMPTY;
+
+	if(hash->old_array){
+		size_t old_pos = hash_old_probe(hash, key_hash, key, length);
 
-	while(pos != old_capacity){
-		if(aux[pos].state == OCCUPIED){
-			hash_store(hash, aux[pos].key, aux[pos].value);
-			free(aux[pos].key);
+		if(hash->old_array[old_pos].state == OCCUPIED){
+			if (hash->destroy){
+				hash->destroy(hash->old_array[old_pos].value);
+			}
+
+			node = hash->old_array[old_pos];
+			hash->old_array[old_pos].state = REMOVED;
+			hash->items--;
+		}
+	}
+	
+	if(node.state != OCCUPIED){
+		if(!hash_node_set_key(&node, key, length)){
+			return false;
 		}
 
-		pos++;
+		node.hash = key_hash;
+		node.state = OCCUPIED;
 	}
 
-	free(aux);
+	node.value = data;
+	hash_insert(hash, node);
+	hash->items++;
 	return true;
 }
 
+/*Returns the node that holds the key, once its hash is known (NULL if
+the key is not in the table).*/
+const hash_node_t* hash_get_node(const hash_t* hash, const void* key, size_t length, uint64_t key_hash){
+	size_t pos = hash_find(hash, key_hash, key, length);
+
+	if(pos != hash->size){
+		return &hash->array[pos];
+	}
+		
+	if(hash->old_array){
+		pos = hash_old_probe(hash, key_hash, key, length);
+		
+		if(hash->old_array[pos].state == OCCUPIED){
+			return &hash->old_array[pos];
+		}
+	}
+
+	return NULL;
+}
+
+/*Returns the data associated with the key, once its hash is known.*/
+void* hash_get_hashed(const hash_t* hash, const void* key, size_t length, uint64_t key_hash){
+	const hash_node_t* node = hash_get_node(hash, key, length, key_hash);
+	return node ? node->value : NULL;
+}
+
+/*Stores the data with a key of the given length, resizing the table if
+needed. Returns false in the case of an error.*/
+bool hash_store_key(hash_t* hash, const void* key, size_t length, void* data){
+	hash_migrate(hash, hash->migration_step);
+
+	if(((float)hash->items / (float)hash->size) * PERCENT >= hash->max_load){
+		 bool redimension = hash_resize(hash);
+		 
+		 if (!redimension){
+			 return false;
+		 }
+	 }
+
+	return hash_store_hashed(hash, key, length, hash->hash_function(key, length), data);
+}
+
+/*Removes the element with a key of the given length, and returns its
+data.*/
+void* hash_remove_key(hash_t* hash, const void* key, size_t length){
+	if(hash->size > hash->min_size && hash->min_load >= (((float)hash->items / (float)hash->size) * PERCENT)){
+		 bool redimension = hash_resize(hash);
+		 
+		 if (!redimension){
+			 return NULL;
+		 }
+	 }
+
+	hash_migrate(hash, hash->migration_step);
+	uint64_t key_hash = hash->hash_function(key, length);
+	size_t pos = hash_find(hash, key_hash, key, length);
+	void* value;
+
+	if(pos != hash->size){
+		value = hash->array[pos].value;
+		hash_node_free_key(&hash->array[pos]);
+		hash_shift_back(hash, pos);
+	}
+
+	else{
+		if(!hash->old_array){
+			return NULL;
+		}
+
+		hash_node_t* node = &hash->old_array[hash_old_probe(hash, key_hash, key, length)];
+
+		if(node->state != OCCUPIED){
+			return NULL;
+		}
+
+		value = node->value;
+		hash_node_free_key(node);
+		node->state = REMOVED;
+	}
+
+	hash->items--;
+	return value;
+}
+
 /*******************************************************************
  *Primitives				
  ******************************************************************/
 
 hash_t *hash_create(hash_destroy_data_t destroy_data){
+	return hash_create_with_capacity(destroy_data, 0);
+}
+
+hash_t *hash_create_with_capacity(hash_destroy_data_t destroy_data, size_t capacity){
 	hash_t * hash = malloc(sizeof(hash_t));
 	
 	if(hash == NULL){
 		return NULL;
 	}
 	
-	hash->array = malloc(sizeof(hash_node_t) * CAPACITY);
+	hash->max_load = MAX_LOAD;
+	hash->min_load = MIN_LOAD;
+	hash->size = hash_size_for(hash, capacity);
+	hash->min_size = hash->size;
+	hash->array = hash_array_create(hash->size);
 	
 	if (hash->array == NULL){
 		free(hash);
@@ -111,17 +519,55 @@ hash_t *hash_create(hash_destroy_data_t destroy_data){
 	}
 	
 	hash->items = 0;
-	hash->size = CAPACITY;
-	
-	for (int pos = 0; pos < (hash->size); pos++){
-		hash->array[pos].state = EMPTY;
-	}
-	
+	hash->old_array = NULL;
+	hash->old_size = 0;
+	hash->migration_start = 0;
+	hash->migrated = 0;
+	hash->migration_step = MIGRATION_STEP;
+	hash->hash_function = hash_function_wyhash;
+	hash->key_equal = NULL;
 	hash->destroy = destroy_data;
 	return hash;	
 }
 
+bool hash_reserve(hash_t *hash, size_t capacity){
+	if(capacity < hash->items){
+		capacity = hash->items;
+	}
+
+	size_t size = hash_size_for(hash, capacity);
+	hash->min_size = size;
+
+	if(size <= hash->size){
+		return true;
+	}
+
+	return hash_rehash(hash, size);
+}
+
+bool hash_shrink_to_fit(hash_t *hash){
+	size_t size = hash_size_for(hash, hash->items);
+	hash->min_size = CAPACITY;
+
+	if(size == hash->size && !hash->old_array){
+		return true;
+	}
+
+	return hash_rehash(hash, size);
+}
+
+bool hash_set_load_factors(hash_t *hash, size_t max_load, size_t min_load){
+	if(max_load == 0 || max_load > MAX_LOAD_LIMIT || min_load * 2 + MIN_LOAD_GAP > max_load){
+		return false;
+	}
+
+	hash->max_load = max_load;
+	hash->min_load = min_load;
+	return true;
+}
+
 void hash_destroy(hash_t *hash){
+	hash_migrate(hash, hash->old_size);
 	size_t pos = 0;
 
 	while(pos != hash->size ){
@@ -130,7 +576,7 @@ void hash_destroy(hash_t *hash){
 				hash->destroy(hash->array[pos].value);
 			}
 			
-			free(hash->array[pos].key);
+			hash_node_free_key(&hash->array[pos]);
 		}
 		
 		pos++;
@@ -140,94 +586,167 @@ void hash_destroy(hash_t *hash){
 	free(hash);
 }
 
-size_t hash_size(const hash_t *hash){
-	return hash->items;
+void hash_destroy_keeping_data(hash_t *hash){
+	hash->destroy = NULL;
+	hash_destroy(hash);
 }
 
-bool hash_store(hash_t *hash, const char *key, void *data){
-	if(((float)hash->items / (float)hash->size) * PERCENT >= MAX_LOAD){
-		 bool redimension = hash_resize(hash);
-		 
-		 if (!redimension){
-			 return false;
-		 }
-	 }
+bool hash_set_hash_function(hash_t *hash, hash_function_t hash_function){
+	if(hash->items != 0){
+		return false;
+	}
 
-	size_t pos = hashing(key, hash->size);
-	
-	while(hash->array[pos].state != EMPTY){
-		if(hash->array[pos].state != REMOVED){
-			if (strcmp(hash->array[pos].key, key) == 0){
-				if (hash->destroy){
-					hash->destroy(hash->array[pos].value);
-				}
-
-				hash->items--;
-				free(hash->array[pos].key);
-				break;
+	hash->hash_function = hash_function;
+	return true;
+}
+
+bool hash_set_key_equal(hash_t *hash, hash_key_equal_t key_equal){
+	if(hash->items != 0){
+		return false;
+	}
+
+	hash->key_equal = key_equal;
+	return true;
+}
+
+hash_function_t hash_get_hash_function(const hash_t *hash){
+	return hash->hash_function;
+}
+
+hash_key_equal_t hash_get_key_equal(const hash_t *hash){
+	return hash->key_equal;
+}
+
+void hash_stats(const hash_t *hash, hash_stats_t *stats){
+	size_t total = 0;
+	stats->max_probe_length = 0;
+
+	for(size_t pos = 0; pos < hash->size; pos++){
+		if(hash->array[pos].state == OCCUPIED){
+			size_t probe_length = hash_distance(hash, pos) + 1;
+			total += probe_length;
+
+			if(probe_length > stats->max_probe_length){
+				stats->max_probe_length = probe_length;
 			}
 		}
+	}
 
-		pos++;
-		
-		if(pos == hash->size){
-			pos = 0;
+	for(size_t pos = 0; pos < hash->old_size; pos++){
+		if(hash->old_array[pos].state == OCCUPIED){
+			size_t probe_length = ((pos - hash->old_array[pos].hash) & (hash->old_size - 1)) + 1;
+			total += probe_length;
+
+			if(probe_length > stats->max_probe_length){
+				stats->max_probe_length = probe_length;
+			}
 		}
 	}
-	
-	hash->array[pos].key = malloc(strlen(key) + 1);
-	strcpy(hash->array[pos].key, key);
-	hash->array[pos].value = data;
-	hash->array[pos].state = OCCUPIED;
-	hash->items++;
-	return true;
+
+	stats->mean_probe_length = hash->items ? (double)total / (double)hash->items : 0;
+}
+
+size_t hash_size(const hash_t *hash){
+	return hash->items;
+}
+
+bool hash_store(hash_t *hash, const char *key, void *data){
+	return hash_store_key(hash, key, strlen(key), data);
 }
 
 void *hash_remove(hash_t *hash, const char *key){
-	if((float)hash->size != CAPACITY && MIN_LOAD >= (((float)hash->items / (float)hash->size) * PERCENT)){
-		 bool redimension = hash_resize(hash);
-		 
-		 if (!redimension){
-			 return false;
-		 }
-	 }
+	return hash_remove_key(hash, key, strlen(key));
+}
 
-	size_t pos = hashing(key, hash->size);
-	
-	while(hash->array[pos].state != EMPTY){
-		if(hash->array[pos].state == OCCUPIED && strcmp(hash->array[pos].key, key) == 0){
-			hash->array[pos].state = REMOVED;
-			hash->items--;
-			free(hash->array[pos].key);
-			return hash->array[pos].value;
+void* hash_get(const hash_t *hash, const char *key){
+	size_t length = strlen(key);
+	return hash_get_hashed(hash, key, length, hash->hash_function(key, length));
+}
+
+bool hash_store_bytes(hash_t *hash, const void *key, size_t length, void *data){
+	return hash_store_key(hash, key, length, data);
+}
+
+void *hash_remove_bytes(hash_t *hash, const void *key, size_t length){
+	return hash_remove_key(hash, key, length);
+}
+
+void *hash_get_bytes(const hash_t *hash, const void *key, size_t length){
+	return hash_get_hashed(hash, key, length, hash->hash_function(key, length));
+}
+
+bool hash_is_in_bytes(const hash_t *hash, const void *key, size_t length){
+	return hash_get_node(hash, key, length, hash->hash_function(key, length)) != NULL;
+}
+
+bool hash_store_int(hash_t *hash, uint64_t key, void *data){
+	return hash_store_key(hash, &key, sizeof(key), data);
+}
+
+void *hash_remove_int(hash_t *hash, uint64_t key){
+	return hash_remove_key(hash, &key, sizeof(key));
+}
+
+void *hash_get_int(const hash_t *hash, uint64_t key){
+	return hash_get_hashed(hash, &key, sizeof(key), hash->hash_function(&key, sizeof(key)));
+}
+
+bool hash_is_in_int(const hash_t *hash, uint64_t key){
+	return hash_get_node(hash, &key, sizeof(key), hash->hash_function(&key, sizeof(key))) != NULL;
+}
+
+bool hash_store_batch(hash_t *hash, const char *const *keys, void *const *data, size_t count){
+	size_t capacity = hash_size_for(hash, hash->items + count);
+
+	if(capacity < hash->size){
+		capacity = hash->size;
+	}
+
+	hash_migrate(hash, hash->old_size);
+
+	if(capacity != hash->size && !hash_rehash(hash, capacity)){
+		return false;
+	}
+
+	size_t lengths[BATCH_SIZE];
+	uint64_t hashes[BATCH_SIZE];
+
+	for(size_t first = 0; first < count; first += BATCH_SIZE){
+		size_t batch = count - first < BATCH_SIZE ? count - first : BATCH_SIZE;
+
+		for(size_t i = 0; i < batch; i++){
+			lengths[i] = strlen(keys[first + i]);
+			hashes[i] = hash->hash_function(keys[first + i], lengths[i]);
+			PREFETCH(&hash->array[hashes[i] & (hash->size - 1)]);
 		}
 
-		pos++;
-		
-		if(pos == hash->size){
-			pos = 0;
+		for(size_t i = 0; i < batch; i++){
+			if(!hash_store_hashed(hash, keys[first + i], lengths[i], hashes[i], data[first + i])){
+				return false;
+			}
 		}
 	}
 
-	return NULL;	
+	return true;
 }
 
-void* hash_get(const hash_t *hash, const char *key){
-	size_t pos = hashing(key, hash->size);
+void hash_get_batch(const hash_t *hash, const char *const *keys, void **data, size_t count){
+	size_t lengths[BATCH_SIZE];
+	uint64_t hashes[BATCH_SIZE];
 
-	while(hash->array[pos].state != EMPTY){
-		if(hash->array[pos].state == OCCUPIED && strcmp(hash->array[pos].key, key) == 0){
-			return hash->array[pos].value;
+	for(size_t first = 0; first < count; first += BATCH_SIZE){
+		size_t batch = count - first < BATCH_SIZE ? count - first : BATCH_SIZE;
+
+		for(size_t i = 0; i < batch; i++){
+			lengths[i] = strlen(keys[first + i]);
+			hashes[i] = hash->hash_function(keys[first + i], lengths[i]);
+			PREFETCH(&hash->array[hashes[i] & (hash->size - 1)]);
 		}
-		
-		pos++;
-		
-		if(pos == hash->size){
-			pos = 0;
+
+		for(size_t i = 0; i < batch; i++){
+			data[first + i] = hash_get_hashed(hash, keys[first + i], lengths[i], hashes[i]);
 		}
 	}
-
-	return NULL;
 }
 
 bool hash_is_in(const hash_t *hash, const char *key){
@@ -241,6 +760,16 @@ bool hash_is_in(const hash_t *hash, const char *key){
 
 /*Iterator*/
 
+/*Returns the node at the given iterator position. Positions cover the
+array being migrated (if any) followed by the current one.*/
+const hash_node_t* hash_iter_node(const hash_iter_t* iter, size_t position){
+	if(position < iter->hash->old_size){
+		return &iter->hash->old_array[position];
+	}
+
+	return &iter->hash->array[position - iter->hash->old_size];
+}
+
 hash_iter_t *hash_iter_create(const hash_t *hash){
 	hash_iter_t* iter = malloc(sizeof(hash_iter_t));
 	
@@ -255,7 +784,7 @@ hash_iter_t *hash_iter_create(const hash_t *hash){
 }
 
 bool hash_iter_at_end(const hash_iter_t *iter){
-	return (iter->position == iter->hash->size);
+	return (iter->position == iter->hash->old_size + iter->hash->size);
 }
 
 bool hash_iter_next(hash_iter_t *iter){
@@ -265,8 +794,8 @@ bool hash_iter_next(hash_iter_t *iter){
 	
 	iter->position++;
 	
-	while(iter->position != iter->hash->size){
-		if(iter->hash->array[iter->position].state == OCCUPIED){
+	while(!hash_iter_at_end(iter)){
+		if(hash_iter_node(iter, iter->position)->state == OCCUPIED){
 			break;
 		}
 		
@@ -281,7 +810,27 @@ const char *hash_iter_get_current(const hash_iter_t *iter){
 		return NULL;
 	}
 	
-	return iter->hash->array[iter->position].key;
+	return hash_node_key(hash_iter_node(iter, iter->position));
+}
+
+const void *hash_iter_get_current_bytes(const hash_iter_t *iter, size_t *length){
+	if(hash_iter_at_end(iter)){
+		return NULL;
+	}
+
+	const hash_node_t* node = hash_iter_node(iter, iter->position);
+	*length = node->length;
+	return hash_node_key(node);
+}
+
+uint64_t hash_iter_get_current_int(const hash_iter_t *iter){
+	uint64_t key = 0;
+
+	if(!hash_iter_at_end(iter) && hash_iter_node(iter, iter->position)->length >= sizeof(key)){
+		memcpy(&key, hash_node_key(hash_iter_node(iter, iter->position)), sizeof(key));
+	}
+
+	return key;
 }
 
 void hash_iter_destroy(hash_iter_t* iter){
@@ -2,10 +2,18 @@
 #define HASH_H
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "hash_function.h"
 
 /*
 Hash table ("Dictionary") with closed addressing. 
-Only strings are allowed as keys.
+Uses Robin Hood hashing: elements far from the position their hash points
+to take the place of closer ones, which keeps probe lengths short and lets
+unsuccessful searches stop early.
+Keys are strings, sequences of bytes or 64 bit integers (the '_bytes' and
+'_int' variants of the primitives). An integer key is the same as its 8
+bytes, and it is always stored in the table itself.
+Needs the hashing functions to work.
 */
 
 /*******************************************************************
@@ -18,6 +26,15 @@ typedef struct hash hash_t;
 typedef struct hash_iter hash_iter_t;
 typedef void (*hash_destroy_data_t)(void *);
 
+/*Returns true if two keys of the given length are equal.*/
+typedef bool (*hash_key_equal_t)(const void *, const void *, size_t);
+
+/*Probe lengths: number of slots read to find each element.*/
+typedef struct hash_stats{
+	size_t max_probe_length;
+	double mean_probe_length;
+}hash_stats_t;
+
 /*******************************************************************
  *Primitives			
  ******************************************************************/
@@ -27,8 +44,34 @@ typedef void (*hash_destroy_data_t)(void *);
 /*Creates a new hash table.*/
 hash_t *hash_create(hash_destroy_data_t destroy_data);
 
+/*Creates a new hash table, with room for 'capacity' elements (it will not
+be resized until that many elements are stored, nor shrink below that
+size).*/
+hash_t *hash_create_with_capacity(hash_destroy_data_t destroy_data, size_t capacity);
+
+/*Makes room for 'capacity' elements: the hash table will not be resized
+until that many elements are stored, nor shrink below that size.
+Unlike the resizes done by stores and removals, which are spread among the
+following operations, it moves every element at once (O(n) time).
+Returns false in the case of an error.*/
+bool hash_reserve(hash_t *hash, size_t capacity);
+
+/*Resizes the hash table to the smallest size that can hold its elements,
+and cancels any previous reservation. Like hash_reserve, it moves every
+element at once (O(n) time). Returns false in the case of an error.*/
+bool hash_shrink_to_fit(hash_t *hash);
+
+/*Sets the loads (percentage of used slots) at which the hash table grows
+(70 by default, at most 95) and shrinks (15 by default). 'min_load' must be
+at most half of 'max_load' minus 5, so a resize never triggers the
+opposite one and leaves enough operations to move the elements to the
+new array a few at a time.
+Returns false if the values are not valid.*/
+bool hash_set_load_factors(hash_t *hash, size_t max_load, size_t min_load);
+
 /*Stores a new element in the hash table. If the key already exists , is 
-replaced. Returns false in the case of an error.*/
+replaced. Returns false in the case of an error, or if the key is longer
+than UINT32_MAX bytes.*/
 bool hash_store(hash_t *hash, const char *key, void *data);
 
 /*Removes an element from the hash table, and returns its data.*/
@@ -37,15 +80,61 @@ void *hash_remove(hash_t *hash, const char *key);
 /*Returns the data associated with the given key.*/
 void *hash_get(const hash_t *hash, const char *key);
 
+/*Stores 'count' elements (keys[i] associated with data[i]), as
+hash_store does. The hash table is resized at most once, to hold all of
+them. Returns false in the case of an error (some elements may have
+been stored).*/
+bool hash_store_batch(hash_t *hash, const char *const *keys, void *const *data, size_t count);
+
+/*Saves in data[i] the data associated with keys[i], for the 'count' given
+keys. Faster than calling hash_get for each of them, since independent
+searches overlap their memory accesses.*/
+void hash_get_batch(const hash_t *hash, const char *const *keys, void **data, size_t count);
+
 /*Returns true if the key is in the hash table.*/
 bool hash_is_in(const hash_t *hash, const char *key);
 
+/*Same as hash_store, hash_remove, hash_get and hash_is_in, with a key of
+'length' bytes (it can contain '\0').*/
+bool hash_store_bytes(hash_t *hash, const void *key, size_t length, void *data);
+void *hash_remove_bytes(hash_t *hash, const void *key, size_t length);
+void *hash_get_bytes(const hash_t *hash, const void *key, size_t length);
+bool hash_is_in_bytes(const hash_t *hash, const void *key, size_t length);
+
+/*Same as hash_store, hash_remove, hash_get and hash_is_in, with an
+integer key.*/
+bool hash_store_int(hash_t *hash, uint64_t key, void *data);
+void *hash_remove_int(hash_t *hash, uint64_t key);
+void *hash_get_int(const hash_t *hash, uint64_t key);
+bool hash_is_in_int(const hash_t *hash, uint64_t key);
+
+/*Sets the function used to hash the keys (hash_function_wyhash by default).
+Only possible while the hash table is empty: returns false otherwise.*/
+bool hash_set_hash_function(hash_t *hash, hash_function_t hash_function);
+
+/*Sets the function used to compare keys with the same hash and length
+(memcmp by default). Only possible while the hash table is empty: returns
+false otherwise.*/
+bool hash_set_key_equal(hash_t *hash, hash_key_equal_t key_equal);
+
+/*Return the functions used to hash and compare the keys. The comparison
+function is NULL if the keys are compared with memcmp.*/
+hash_function_t hash_get_hash_function(const hash_t *hash);
+hash_key_equal_t hash_get_key_equal(const hash_t *hash);
+
+/*Saves in 'stats' the maximum and mean probe length of the elements in
+the hash table.*/
+void hash_stats(const hash_t *hash, hash_stats_t *stats);
+
 /*Returns the number of elements in the hash table.*/
 size_t hash_size(const hash_t *hash);
 
 /*Destroys the hash table.*/
 void hash_destroy(hash_t *hash);
 
+/*Destroys the hash table, but not the data of its elements.*/
+void hash_destroy_keeping_data(hash_t *hash);
+
 /*Iterator*/
 
 /*Creates an iterator.*/
@@ -58,6 +147,13 @@ bool hash_iter_next(hash_iter_t *iter);
 /*Returns the key of the current element being iterated.*/
 const char *hash_iter_get_current(const hash_iter_t *iter);
 
+/*Returns the key of the current element being iterated, and saves its
+length in 'length'.*/
+const void *hash_iter_get_current_bytes(const hash_iter_t *iter, size_t *length);
+
+/*Returns the integer key of the current element being iterated.*/
+uint64_t hash_iter_get_current_int(const hash_iter_t *iter);
+
 /*Returns true if the iterator won't move any further.*/
 bool hash_iter_at_end(const hash_iter_t *iter);
 
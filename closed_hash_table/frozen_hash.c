@@ -0,0 +1,397 @@
+#include "frozen_hash.h"
+#include "hash_function.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KEYS_PER_BUCKET 5
+#define LOAD_PERCENTAGE 98
+#define MAX_PILOT UINT16_MAX
+#define MAX_SEEDS 16
+#define KEY_ALIGNMENT 8
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+typedef struct hash_frozen_entry{
+	const void* key;
+	size_t length;
+	void* value;
+}hash_frozen_entry_t;
+
+/*The keys are split into 'buckets' by their hash. Each bucket has a
+'pilot', chosen so that the positions of its keys (given by their hash and
+the pilot) are free, among 'positions' (a bit more than the number of
+keys, which makes pilots easier to find).
+Positions from 'items' on are then moved to the free ones below it,
+through 'remap', so that 'entries' has no holes.
+All keys are stored one after another in 'keys', each one starting at a
+multiple of KEY_ALIGNMENT.
+Keys are compared with the function of the hash table it was built from,
+and also hashed with its function when that one is not memcmp.*/
+struct hash_frozen{
+	size_t items;
+	size_t positions;
+	size_t buckets;
+	uint64_t seed;
+	hash_function_t hash_function;
+	hash_key_equal_t key_equal;
+	uint16_t* pilots;
+	uint32_t* remap;
+	hash_frozen_entry_t* entries;
+	char* keys;
+};
+
+/*******************************************************************
+ *Auxiliary Functions
+ ******************************************************************/
+
+/*Mixes the bits of a 64 bit number (splitmix64 finalizer).*/
+uint64_t frozen_mix(uint64_t x){
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+uint64_t frozen_hash(const hash_frozen_t* frozen, const void* key, size_t length){
+	return frozen_mix(frozen->hash_function(key, length) ^ frozen->seed);
+}
+
+/*Returns true if the key of the entry is the given one.*/
+bool frozen_key_equal(const hash_frozen_t* frozen, const hash_frozen_entry_t* entry, const void* key, size_t length){
+	if(entry->length != length){
+		return false;
+	}
+
+	if(frozen->key_equal){
+		return frozen->key_equal(entry->key, key, length);
+	}
+
+	return memcmp(entry->key, key, length) == 0;
+}
+
+size_t frozen_bucket(const hash_frozen_t* frozen, uint64_t key_hash){
+	return (size_t)((key_hash >> 32) % frozen->buckets);
+}
+
+size_t frozen_position(const hash_frozen_t* frozen, uint64_t key_hash, uint16_t pilot){
+	return (size_t)(frozen_mix(key_hash ^ ((uint64_t)pilot * 0x9e3779b97f4a7c15ULL)) % frozen->positions);
+}
+
+/*Returns the position of the entry of a key with the given hash.*/
+size_t frozen_entry(const hash_frozen_t* frozen, uint64_t key_hash){
+	size_t pos = frozen_position(frozen, key_hash, frozen->pilots[frozen_bucket(frozen, key_hash)]);
+	return pos < frozen->items ? pos : frozen->remap[pos - frozen->items];
+}
+
+/*Returns the entry that the key would have, or NULL if the frozen hash
+table is empty.*/
+const hash_frozen_entry_t* frozen_find(const hash_frozen_t* frozen, const void* key, size_t length){
+	if(frozen->items == 0){
+		return NULL;
+	}
+
+	return &frozen->entries[frozen_entry(frozen, frozen_hash(frozen, key, length))];
+}
+
+/*Searches a pilot for every bucket (the largest ones first, while there
+are more free positions), saving in 'taken' the used positions. 'hashes'
+has the hash of every key with the seed of the frozen table. Returns
+false if some bucket has no valid pilot.*/
+bool frozen_find_pilots(hash_frozen_t* frozen, const uint64_t* hashes, bool* taken){
+	size_t* start = calloc(frozen->buckets + 1, sizeof(size_t));
+	size_t* next = malloc(sizeof(size_t) * frozen->buckets);
+	size_t* by_size = malloc(sizeof(size_t) * frozen->buckets);
+	size_t* order = malloc(sizeof(size_t) * (frozen->items + 1));
+	size_t* pos = malloc(sizeof(size_t) * (frozen->items + 1));
+	size_t* count = NULL;
+	bool ok = start && next && by_size && order && pos;
+
+	if(ok){
+		/*Counting sort of the keys by bucket.*/
+		for(size_t i = 0; i < frozen->items; i++){
+			start[frozen_bucket(frozen, hashes[i]) + 1]++;
+		}
+
+		size_t max_size = 0;
+
+		for(size_t b = 0; b < frozen->buckets; b++){
+			max_size = start[b + 1] > max_size ? start[b + 1] : max_size;
+			start[b + 1] += start[b];
+		}
+
+		memcpy(next, start, sizeof(size_t) * frozen->buckets);
+
+		for(size_t i = 0; i < frozen->items; i++){
+			order[next[frozen_bucket(frozen, hashes[i])]++] = i;
+		}
+
+		/*Counting sort of the buckets by decreasing size.*/
+		count = calloc(max_size + 2, sizeof(size_t));
+		ok = count != NULL;
+
+		for(size_t b = 0; ok && b < frozen->buckets; b++){
+			count[max_size - (start[b + 1] - start[b]) + 1]++;
+		}
+
+		for(size_t s = 0; ok && s <= max_size; s++){
+			count[s + 1] += count[s];
+		}
+
+		for(size_t b = 0; ok && b < frozen->buckets; b++){
+			by_size[count[max_size - (start[b + 1] - start[b])]++] = b;
+		}
+	}
+
+	for(size_t i = 0; ok && i < frozen->buckets; i++){
+		size_t b = by_size[i];
+		size_t size = start[b + 1] - start[b];
+		bool found = size == 0;
+
+		for(uint32_t pilot = 0; !found && pilot <= MAX_PILOT; pilot++){
+			size_t k;
+
+			for(k = 0; k < size; k++){
+				pos[k] = frozen_position(frozen, hashes[order[start[b] + k]], (uint16_t)pilot);
+
+				if(taken[pos[k]]){
+					break;
+				}
+
+				taken[pos[k]] = true;
+			}
+
+			found = k == size;
+
+			if(!found){
+				while(k-- > 0){
+					taken[pos[k]] = false;
+				}
+			}
+
+			else{
+				frozen->pilots[b] = (uint16_t)pilot;
+			}
+		}
+
+		if(size == 0){
+			frozen->pilots[b] = 0;
+		}
+
+		ok = found;
+	}
+
+	free(start);
+	free(next);
+	free(by_size);
+	free(order);
+	free(pos);
+	free(count);
+	return ok;
+}
+
+/*Moves the used positions from 'items' on to the free ones below it. The
+unused ones (only reached by keys that are not in the table) go to 0.*/
+void frozen_build_remap(hash_frozen_t* frozen, const bool* taken){
+	size_t free_pos = 0;
+
+	for(size_t pos = frozen->items; pos < frozen->positions; pos++){
+		if(!taken[pos]){
+			frozen->remap[pos - frozen->items] = 0;
+			continue;
+		}
+
+		while(taken[free_pos]){
+			free_pos++;
+		}
+
+		frozen->remap[pos - frozen->items] = (uint32_t)free_pos++;
+	}
+}
+
+/*Returns the space taken by a key of the given length in 'keys'.*/
+size_t frozen_key_space(size_t length){
+	return (length + KEY_ALIGNMENT - 1) / KEY_ALIGNMENT * KEY_ALIGNMENT;
+}
+
+/*Copies the keys of the hash table one after another, and saves them
+with their length and data in 'elements'. Returns false in the case of an
+error.*/
+bool frozen_copy_keys(hash_frozen_t* frozen, hash_t* hash, hash_frozen_entry_t* elements){
+	hash_iter_t* iter = hash_iter_create(hash);
+	size_t space = 0;
+
+	if(!iter){
+		return false;
+	}
+
+	for(; !hash_iter_at_end(iter); hash_iter_next(iter)){
+		size_t length;
+		hash_iter_get_current_bytes(iter, &length);
+		space += frozen_key_space(length);
+	}
+
+	hash_iter_destroy(iter);
+	frozen->keys = malloc(space + 1);
+	iter = hash_iter_create(hash);
+
+	if(!frozen->keys || !iter){
+		if(iter){
+			hash_iter_destroy(iter);
+		}
+
+		return false;
+	}
+
+	char* key = frozen->keys;
+
+	for(size_t i = 0; !hash_iter_at_end(iter); hash_iter_next(iter), i++){
+		size_t length;
+		const void* current = hash_iter_get_current_bytes(iter, &length);
+		memcpy(key, current, length);
+		elements[i].key = key;
+		elements[i].length = length;
+		key += frozen_key_space(length);
+	}
+
+	hash_iter_destroy(iter);
+
+	/*The data is searched after iterating, because searches can move
+	elements (see hash_set_move_to_front in the open hash table).*/
+	for(size_t i = 0; i < frozen->items; i++){
+		elements[i].value = hash_get_bytes(hash, elements[i].key, elements[i].length);
+	}
+
+	return true;
+}
+
+/*Searches the pilots, trying different seeds, and fills the entries.
+Returns false if no seed worked or in the case of an error.*/
+bool frozen_build(hash_frozen_t* frozen, const hash_frozen_entry_t* elements){
+	uint64_t* hashes = malloc(sizeof(uint64_t) * (frozen->items + 1));
+	bool* taken = malloc(frozen->positions);
+	bool ok = false;
+
+	for(uint64_t seed = 0; hashes && taken && !ok && seed < MAX_SEEDS; seed++){
+		frozen->seed = frozen_mix(seed + 1);
+
+		for(size_t i = 0; i < frozen->items; i++){
+			hashes[i] = frozen_hash(frozen, elements[i].key, elements[i].length);
+		}
+
+		memset(taken, false, frozen->positions);
+		ok = frozen_find_pilots(frozen, hashes, taken);
+	}
+
+	if(ok){
+		frozen_build_remap(frozen, taken);
+
+		for(size_t i = 0; i < frozen->items; i++){
+			frozen->entries[frozen_entry(frozen, hashes[i])] = elements[i];
+		}
+	}
+
+	free(hashes);
+	free(taken);
+	return ok;
+}
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+hash_frozen_t *hash_freeze(hash_t *hash){
+	size_t items = hash_size(hash);
+
+	if(items >= UINT32_MAX){
+		return NULL;
+	}
+
+	hash_frozen_t* frozen = malloc(sizeof(hash_frozen_t));
+	hash_frozen_entry_t* elements = malloc(sizeof(hash_frozen_entry_t) * (items + 1));
+
+	if(!frozen || !elements){
+		free(frozen);
+		free(elements);
+		return NULL;
+	}
+
+	/*With memcmp any hashing function works, so wyhash is used: a weaker
+	one could give the same 64 bits to two keys, which no pilot separates.*/
+	frozen->key_equal = hash_get_key_equal(hash);
+	frozen->hash_function = frozen->key_equal ? hash_get_hash_function(hash) : hash_function_wyhash;
+	frozen->items = items;
+	frozen->positions = items * 100 / LOAD_PERCENTAGE + 1;
+	frozen->buckets = items / KEYS_PER_BUCKET + 1;
+	frozen->pilots = malloc(sizeof(uint16_t) * frozen->buckets);
+	frozen->remap = malloc(sizeof(uint32_t) * (frozen->positions - items));
+	frozen->entries = malloc(sizeof(hash_frozen_entry_t) * (items + 1));
+	frozen->keys = NULL;
+
+	bool ok = frozen->pilots && frozen->remap && frozen->entries &&
+	          frozen_copy_keys(frozen, hash, elements) &&
+	          frozen_build(frozen, elements);
+
+	if(ok){
+		/*The data now belongs to the frozen hash table.*/
+		hash_destroy_keeping_data(hash);
+	}
+
+	else{
+		free(frozen->pilots);
+		free(frozen->remap);
+		free(frozen->entries);
+		free(frozen->keys);
+		free(frozen);
+		frozen = NULL;
+	}
+
+	free(elements);
+	return frozen;
+}
+
+void *hash_frozen_get(const hash_frozen_t *frozen, const char *key){
+	return hash_frozen_get_bytes(frozen, key, strlen(key));
+}
+
+bool hash_frozen_is_in(const hash_frozen_t *frozen, const char *key){
+	return hash_frozen_is_in_bytes(frozen, key, strlen(key));
+}
+
+void *hash_frozen_get_bytes(const hash_frozen_t *frozen, const void *key, size_t length){
+	const hash_frozen_entry_t* entry = frozen_find(frozen, key, length);
+	return entry && frozen_key_equal(frozen, entry, key, length) ? entry->value : NULL;
+}
+
+bool hash_frozen_is_in_bytes(const hash_frozen_t *frozen, const void *key, size_t length){
+	const hash_frozen_entry_t* entry = frozen_find(frozen, key, length);
+	return entry && frozen_key_equal(frozen, entry, key, length);
+}
+
+void *hash_frozen_get_int(const hash_frozen_t *frozen, uint64_t key){
+	return hash_frozen_get_bytes(frozen, &key, sizeof(key));
+}
+
+bool hash_frozen_is_in_int(const hash_frozen_t *frozen, uint64_t key){
+	return hash_frozen_is_in_bytes(frozen, &key, sizeof(key));
+}
+
+size_t hash_frozen_size(const hash_frozen_t *frozen){
+	return frozen->items;
+}
+
+void hash_frozen_destroy(hash_frozen_t *frozen, hash_destroy_data_t destroy_data){
+	for(size_t i = 0; destroy_data && i < frozen->items; i++){
+		destroy_data(frozen->entries[i].value);
+	}
+
+	free(frozen->pilots);
+	free(frozen->remap);
+	free(frozen->entries);
+	free(frozen->keys);
+	free(frozen);
+}
@@ -0,0 +1,57 @@
+#ifndef FROZEN_HASH_H
+#define FROZEN_HASH_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "closed_hash.h"
+
+/*
+Read-only hash table built from the elements of a hash table that will not
+change anymore. It uses a minimal perfect hash function (PTHash style):
+every key has its own position in an array with exactly one element per
+key, so a search reads a single position and compares a single key.
+Besides the elements, it only takes about 4 bits per key.
+Keys can be strings, sequences of bytes or integers, as in the hash table,
+and are compared with the same function.
+Needs the hash table and the hashing functions to work.
+*/
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+struct hash_frozen;
+typedef struct hash_frozen hash_frozen_t;
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+/*Creates a frozen hash table with the elements of the hash table, which
+is destroyed (its data now belongs to the frozen one). Returns NULL in the
+case of an error, and then the hash table is left unchanged.*/
+hash_frozen_t *hash_freeze(hash_t *hash);
+
+/*Returns the data associated with the given key.*/
+void *hash_frozen_get(const hash_frozen_t *frozen, const char *key);
+
+/*Returns true if the key is in the frozen hash table.*/
+bool hash_frozen_is_in(const hash_frozen_t *frozen, const char *key);
+
+/*Same as hash_frozen_get and hash_frozen_is_in, with a key of 'length'
+bytes.*/
+void *hash_frozen_get_bytes(const hash_frozen_t *frozen, const void *key, size_t length);
+bool hash_frozen_is_in_bytes(const hash_frozen_t *frozen, const void *key, size_t length);
+
+/*Same as hash_frozen_get and hash_frozen_is_in, with an integer key.*/
+void *hash_frozen_get_int(const hash_frozen_t *frozen, uint64_t key);
+bool hash_frozen_is_in_int(const hash_frozen_t *frozen, uint64_t key);
+
+/*Returns the number of elements in the frozen hash table.*/
+size_t hash_frozen_size(const hash_frozen_t *frozen);
+
+/*Destroys the frozen hash table, applying 'destroy_data' (if it is not
+NULL) to the data of every element.*/
+void hash_frozen_destroy(hash_frozen_t *frozen, hash_destroy_data_t destroy_data);
+
+#endif // FROZEN_HASH_H
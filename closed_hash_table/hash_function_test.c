@@ -0,0 +1,209 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "hash_function.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+Compares the hashing functions on some representative sets of keys.
+For every function and set it shows:
+- spread: the chi-squared statistic of the number of keys per bucket,
+divided by its expected value (about 1.00 for a uniform hash, and far from
+it when the keys fill the buckets unevenly, or too evenly to be random),
+with the buckets taken from the lowest bits, as the hash tables do.
+- max: the largest number of keys in a bucket.
+- collisions: keys with the same 64 bits hash as a previous one (all keys
+are different).
+- speed: millions of keys hashed per second.
+Compile with: cc -O2 hash_function_test.c hash_function.c
+*/
+
+#define KEYS (1 << 18)
+#define BUCKETS (1 << 16)
+#define ROUNDS 20
+#define MAX_KEY_LENGTH 64
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+typedef struct key_set{
+	const char* name;
+	char* keys;
+	size_t lengths[KEYS];
+}key_set_t;
+
+typedef struct function{
+	const char* name;
+	hash_function_t hash;
+}function_t;
+
+/*******************************************************************
+ *Auxiliary Functions
+ ******************************************************************/
+
+/*Returns the key at position 'i' of the set.*/
+const char* key_at(const key_set_t* set, size_t i){
+	return set->keys + i * MAX_KEY_LENGTH;
+}
+
+/*Returns the next number of a linear congruential generator.*/
+uint64_t next_random(uint64_t* state){
+	*state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return *state >> 33;
+}
+
+/*Fills the set with the kind of keys given by 'kind'. Returns false in the
+case of an error.*/
+bool key_set_fill(key_set_t* set, int kind){
+	static const char* names[] = {"decimal", "prefixed", "words", "integers", "paths"};
+	uint64_t state = 42;
+	set->name = names[kind];
+	set->keys = malloc((size_t)KEYS * MAX_KEY_LENGTH);
+
+	if(!set->keys){
+		return false;
+	}
+
+	for(size_t i = 0; i < KEYS; i++){
+		char* key = set->keys + i * MAX_KEY_LENGTH;
+		int length = 0;
+
+		switch(kind){
+			case 0:
+				length = snprintf(key, MAX_KEY_LENGTH, "%zu", i);
+				break;
+
+			case 1:
+				length = snprintf(key, MAX_KEY_LENGTH, "user:%08zu", i);
+				break;
+
+			case 2:{
+				/*Random letters, but the first four come from 'i', so that
+				no word repeats.*/
+				size_t number = i;
+				length = 4 + (int)(next_random(&state) % 7);
+
+				for(int c = 0; c < length; c++){
+					key[c] = (char)('a' + (c < 4 ? number % 26 : next_random(&state) % 26));
+					number /= 26;
+				}
+
+				break;
+			}
+
+			case 3:{
+				/*Addresses of 4 KB aligned blocks.*/
+				uint64_t address = 0x7f0000000000ULL + (uint64_t)i * 4096;
+				memcpy(key, &address, sizeof(address));
+				length = sizeof(address);
+				break;
+			}
+
+			default:
+				length = snprintf(key, MAX_KEY_LENGTH, "/home/user/projects/data_structures/src/file_%06zu.c", i);
+				break;
+		}
+
+		set->lengths[i] = (size_t)length;
+	}
+
+	return true;
+}
+
+int compare_hashes(const void* a, const void* b){
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+/*Shows the spread, maximum bucket, collisions and speed of the function
+on the set.*/
+void measure(const function_t* function, const key_set_t* set, uint64_t* hashes, size_t* buckets){
+	memset(buckets, 0, sizeof(size_t) * BUCKETS);
+
+	for(size_t i = 0; i < KEYS; i++){
+		hashes[i] = function->hash(key_at(set, i), set->lengths[i]);
+		buckets[hashes[i] & (BUCKETS - 1)]++;
+	}
+
+	double expected = (double)KEYS / BUCKETS;
+	double chi_squared = 0;
+	size_t max = 0;
+
+	for(size_t b = 0; b < BUCKETS; b++){
+		double difference = (double)buckets[b] - expected;
+		chi_squared += difference * difference / expected;
+		max = buckets[b] > max ? buckets[b] : max;
+	}
+
+	qsort(hashes, KEYS, sizeof(uint64_t), compare_hashes);
+	size_t collisions = 0;
+
+	for(size_t i = 1; i < KEYS; i++){
+		collisions += hashes[i] == hashes[i - 1];
+	}
+
+	struct timespec start, end;
+	uint64_t sink = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for(int round = 0; round < ROUNDS; round++){
+		for(size_t i = 0; i < KEYS; i++){
+			sink += function->hash(key_at(set, i), set->lengths[i]);
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+	/*'sink' is printed so that the hashing is not optimized away.*/
+	printf("%-10s %-10s %8.2f %6zu %11zu %9.1f   (%llx)\n", set->name, function->name,
+	       chi_squared / (BUCKETS - 1), max, collisions,
+	       (double)KEYS * ROUNDS / seconds / 1e6, (unsigned long long)(sink & 0xf));
+}
+
+/*******************************************************************
+ *Main
+ ******************************************************************/
+
+int main(void){
+	static const function_t functions[] = {
+		{"wyhash", hash_function_wyhash},
+		{"bernstein", hash_function_bernstein},
+		{"k&r", hash_function_kr}
+	};
+	key_set_t* set = malloc(sizeof(key_set_t));
+	uint64_t* hashes = malloc(sizeof(uint64_t) * KEYS);
+	size_t* buckets = malloc(sizeof(size_t) * BUCKETS);
+
+	if(!set || !hashes || !buckets){
+		free(set);
+		free(hashes);
+		free(buckets);
+		return 1;
+	}
+
+	printf("%d keys, %d buckets\n", KEYS, BUCKETS);
+	printf("%-10s %-10s %8s %6s %11s %9s\n", "keys", "function", "spread", "max", "collisions", "Mkeys/s");
+
+	for(int kind = 0; kind < 5; kind++){
+		if(!key_set_fill(set, kind)){
+			break;
+		}
+
+		for(size_t f = 0; f < sizeof(functions) / sizeof(functions[0]); f++){
+			measure(&functions[f], set, hashes, buckets);
+		}
+
+		free(set->keys);
+	}
+
+	free(set);
+	free(hashes);
+	free(buckets);
+	return 0;
+}
@@ -0,0 +1,333 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "hash_snapshot.h"
+#include "hash_function.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAPSHOT_MAGIC "HASHSNP1"
+#define SNAPSHOT_BYTE_ORDER 0x0102030405060708ULL
+#define ALIGNMENT 8
+#define MAX_TEMP_TRIES 100
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+/*The file starts with the header, followed by 'size' slots (a power of
+two, at most half of them used) and then by the records. Slots are
+searched with linear probing; an offset of 0 means the slot is empty.
+Every record starts at a multiple of ALIGNMENT.*/
+typedef struct snapshot_header{
+	char magic[8];
+	uint64_t byte_order;
+	uint64_t size;
+	uint64_t items;
+	uint64_t file_size;
+}snapshot_header_t;
+
+typedef struct snapshot_slot{
+	uint64_t hash;
+	uint64_t offset;
+}snapshot_slot_t;
+
+/*Followed by the key (with a '\0' after it, which 'key_length' counts)
+and the encoded data.*/
+typedef struct snapshot_record{
+	uint64_t key_length;
+	uint64_t data_length;
+}snapshot_record_t;
+
+struct hash_snapshot{
+	const unsigned char* map;
+	size_t map_size;
+	const snapshot_header_t* header;
+	const snapshot_slot_t* slots;
+};
+
+/*******************************************************************
+ *Auxiliary Functions
+ ******************************************************************/
+
+/*Returns the number of slots for the given number of elements.*/
+uint64_t snapshot_size_for(size_t items){
+	uint64_t size = 16;
+
+	while(size < (uint64_t)items * 2){
+		size *= 2;
+	}
+
+	return size;
+}
+
+/*Writes 'count' zero bytes.*/
+bool snapshot_write_padding(FILE* file, size_t count){
+	static const char zeros[ALIGNMENT];
+	return fwrite(zeros, 1, count, file) == count;
+}
+
+/*Writes the elements of the hash table as records, after the slots, and
+fills the slots with their offsets. Returns the size of the file, or 0 in
+the case of an error.*/
+uint64_t snapshot_write_records(const hash_t* hash, FILE* file, hash_snapshot_encode_t encode,
+                                snapshot_slot_t* slots, uint64_t size){
+	uint64_t offset = sizeof(snapshot_header_t) + sizeof(snapshot_slot_t) * size;
+	hash_iter_t* iter = hash_iter_create(hash);
+
+	if(!iter){
+		return 0;
+	}
+
+	for(; !hash_iter_at_end(iter); hash_iter_next(iter)){
+		size_t key_length;
+		const void* key = hash_iter_get_current_bytes(iter, &key_length);
+		size_t data_length;
+		const void* data = encode(hash_get_bytes(hash, key, key_length), &data_length);
+		snapshot_record_t record = {key_length + 1, data_length};
+		uint64_t key_hash = hash_function_wyhash(key, key_length);
+		uint64_t pos = key_hash & (size - 1);
+
+		while(slots[pos].offset){
+			pos = (pos + 1) & (size - 1);
+		}
+
+		slots[pos].hash = key_hash;
+		slots[pos].offset = offset;
+		uint64_t length = sizeof(record) + record.key_length + record.data_length;
+		uint64_t padding = (ALIGNMENT - length % ALIGNMENT) % ALIGNMENT;
+
+		if(fwrite(&record, sizeof(record), 1, file) != 1 ||
+		   fwrite(key, 1, key_length, file) != key_length ||
+		   !snapshot_write_padding(file, 1) ||
+		   (data_length && fwrite(data, 1, data_length, file) != data_length) ||
+		   !snapshot_write_padding(file, padding)){
+			hash_iter_destroy(iter);
+			return 0;
+		}
+
+		offset += length + padding;
+	}
+
+	hash_iter_destroy(iter);
+	return offset;
+}
+
+/*Creates a new file named as 'path' followed by a unique suffix, and saves
+its name in 'temp_path' (of 'temp_size' bytes). Returns its descriptor, or
+-1 in the case of an error.*/
+int snapshot_create_temp(const char* path, char* temp_path, size_t temp_size){
+	for(unsigned tries = 0; tries < MAX_TEMP_TRIES; tries++){
+		snprintf(temp_path, temp_size, "%s.%ld.%u.tmp", path, (long)getpid(), tries);
+		int descriptor = open(temp_path, O_WRONLY | O_CREAT | O_EXCL, 0666);
+
+		if(descriptor >= 0 || errno != EEXIST){
+			return descriptor;
+		}
+	}
+
+	return -1;
+}
+
+/*Writes the snapshot in 'file'. Returns false in the case of an error.*/
+bool snapshot_write(const hash_t* hash, FILE* file, hash_snapshot_encode_t encode){
+	snapshot_header_t header = {SNAPSHOT_MAGIC, SNAPSHOT_BYTE_ORDER, snapshot_size_for(hash_size(hash)), hash_size(hash), 0};
+	snapshot_slot_t* slots = calloc(header.size, sizeof(snapshot_slot_t));
+
+	if(!slots){
+		return false;
+	}
+
+	/*The records are written first, leaving room for the header and the
+	slots, which are only known at the end.*/
+	bool ok = fseek(file, (long)(sizeof(header) + sizeof(snapshot_slot_t) * header.size), SEEK_SET) == 0;
+	header.file_size = ok ? snapshot_write_records(hash, file, encode, slots, header.size) : 0;
+	ok = header.file_size != 0 &&
+	     fseek(file, 0, SEEK_SET) == 0 &&
+	     fwrite(&header, sizeof(header), 1, file) == 1 &&
+	     fwrite(slots, sizeof(snapshot_slot_t), header.size, file) == header.size;
+	free(slots);
+	return ok;
+}
+
+/*Returns the record of the slot, or NULL if it is not inside the file.*/
+const snapshot_record_t* snapshot_record(const hash_snapshot_t* snapshot, const snapshot_slot_t* slot){
+	uint64_t offset = slot->offset;
+
+	if(offset > snapshot->map_size - sizeof(snapshot_record_t)){
+		return NULL;
+	}
+
+	const snapshot_record_t* record = (const snapshot_record_t*)(snapshot->map + offset);
+	uint64_t left = snapshot->map_size - offset - sizeof(snapshot_record_t);
+
+	if(record->key_length == 0 || record->key_length > left || record->data_length > left - record->key_length){
+		return NULL;
+	}
+
+	return record;
+}
+
+/*Returns the record of the key, or NULL if it is not in the snapshot.*/
+const snapshot_record_t* snapshot_find(const hash_snapshot_t* snapshot, const void* key, size_t key_length){
+	uint64_t key_hash = hash_function_wyhash(key, key_length);
+	uint64_t mask = snapshot->header->size - 1;
+	uint64_t pos = key_hash & mask;
+
+	for(uint64_t n = 0; n <= mask && snapshot->slots[pos].offset; n++, pos = (pos + 1) & mask){
+		const snapshot_slot_t* slot = &snapshot->slots[pos];
+
+		if(slot->hash != key_hash){
+			continue;
+		}
+
+		const snapshot_record_t* record = snapshot_record(snapshot, slot);
+
+		if(record && record->key_length == key_length + 1 &&
+		   memcmp(record + 1, key, key_length) == 0){
+			return record;
+		}
+	}
+
+	return NULL;
+}
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+bool hash_snapshot_save(const hash_t *hash, const char *path, hash_snapshot_encode_t encode){
+	/*The snapshot is written to a new file in the same directory, which
+	then replaces the one at 'path' with rename: a file that is already
+	mapped by a reader is never truncated or modified, and a reader that
+	opens 'path' finds either the old snapshot or the complete new one.*/
+	size_t temp_size = strlen(path) + 32;
+	char* temp_path = malloc(temp_size);
+
+	if(!temp_path){
+		return false;
+	}
+
+	int descriptor = snapshot_create_temp(path, temp_path, temp_size);
+	FILE* file = descriptor >= 0 ? fdopen(descriptor, "wb") : NULL;
+
+	if(!file){
+		if(descriptor >= 0){
+			close(descriptor);
+			remove(temp_path);
+		}
+
+		free(temp_path);
+		return false;
+	}
+
+	bool ok = snapshot_write(hash, file, encode) &&
+	          fflush(file) == 0 &&
+	          fsync(descriptor) == 0;
+
+	if(fclose(file) != 0){
+		ok = false;
+	}
+
+	ok = ok && rename(temp_path, path) == 0;
+
+	if(!ok){
+		remove(temp_path);
+	}
+
+	free(temp_path);
+	return ok;
+}
+
+hash_snapshot_t *hash_snapshot_open(const char *path){
+	int file = open(path, O_RDONLY);
+
+	if(file < 0){
+		return NULL;
+	}
+
+	struct stat status;
+	void* map = MAP_FAILED;
+
+	if(fstat(file, &status) == 0 && (size_t)status.st_size >= sizeof(snapshot_header_t)){
+		map = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	}
+
+	/*The mapping stays valid after closing the file.*/
+	close(file);
+
+	if(map == MAP_FAILED){
+		return NULL;
+	}
+
+	hash_snapshot_t* snapshot = malloc(sizeof(hash_snapshot_t));
+	const snapshot_header_t* header = map;
+	size_t map_size = (size_t)status.st_size;
+
+	if(!snapshot ||
+	   memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+	   header->byte_order != SNAPSHOT_BYTE_ORDER ||
+	   header->file_size != map_size ||
+	   header->size == 0 || (header->size & (header->size - 1)) != 0 ||
+	   header->items >= header->size ||
+	   header->size > (map_size - sizeof(snapshot_header_t)) / sizeof(snapshot_slot_t)){
+		free(snapshot);
+		munmap(map, map_size);
+		return NULL;
+	}
+
+	snapshot->map = map;
+	snapshot->map_size = map_size;
+	snapshot->header = header;
+	snapshot->slots = (const snapshot_slot_t*)(header + 1);
+	return snapshot;
+}
+
+const void *hash_snapshot_get(const hash_snapshot_t *snapshot, const char *key, size_t *length){
+	return hash_snapshot_get_bytes(snapshot, key, strlen(key), length);
+}
+
+const void *hash_snapshot_get_bytes(const hash_snapshot_t *snapshot, const void *key, size_t key_length, size_t *length){
+	const snapshot_record_t* record = snapshot_find(snapshot, key, key_length);
+
+	if(!record){
+		return NULL;
+	}
+
+	if(length){
+		*length = record->data_length;
+	}
+
+	return (const unsigned char*)(record + 1) + record->key_length;
+}
+
+const void *hash_snapshot_get_int(const hash_snapshot_t *snapshot, uint64_t key, size_t *length){
+	return hash_snapshot_get_bytes(snapshot, &key, sizeof(key), length);
+}
+
+bool hash_snapshot_is_in(const hash_snapshot_t *snapshot, const char *key){
+	return snapshot_find(snapshot, key, strlen(key)) != NULL;
+}
+
+bool hash_snapshot_is_in_bytes(const hash_snapshot_t *snapshot, const void *key, size_t key_length){
+	return snapshot_find(snapshot, key, key_length) != NULL;
+}
+
+bool hash_snapshot_is_in_int(const hash_snapshot_t *snapshot, uint64_t key){
+	return snapshot_find(snapshot, &key, sizeof(key)) != NULL;
+}
+
+size_t hash_snapshot_size(const hash_snapshot_t *snapshot){
+	return snapshot->header->items;
+}
+
+void hash_snapshot_close(hash_snapshot_t *snapshot){
+	munmap((void*)snapshot->map, snapshot->map_size);
+	free(snapshot);
+}
@@ -0,0 +1,71 @@
+#ifndef HASH_SNAPSHOT_H
+#define HASH_SNAPSHOT_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "closed_hash.h"
+
+/*
+Read-only copy of a hash table saved in a file. The file is mapped into
+memory when opened: nothing is parsed or allocated per element, and its
+pages are read from disk the first time a search touches them.
+The file has no pointers, so it can be mapped at any address, but it can
+only be opened in a machine with the same byte order.
+The data is saved as the bytes given by an encoding function, and
+searches return a pointer to those bytes inside the file.
+Keys of any kind (strings, bytes or integers) are saved with their length,
+and are compared byte by byte when searched, whatever the hashing and
+comparison functions of the hash table were.
+Needs the closed hash table, the hashing functions and mmap to work.
+*/
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+struct hash_snapshot;
+typedef struct hash_snapshot hash_snapshot_t;
+
+/*Returns the bytes that represent the data, and saves their number in
+'length'.*/
+typedef const void *(*hash_snapshot_encode_t)(const void *data, size_t *length);
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+/*Saves the elements of the hash table in the file at 'path', encoding
+their data with 'encode'. The file is written next to 'path' and then
+renamed to it, so snapshots that are open keep their old contents, and
+on errors 'path' is left unchanged. Returns false in the case of an
+error.*/
+bool hash_snapshot_save(const hash_t *hash, const char *path, hash_snapshot_encode_t encode);
+
+/*Opens the snapshot saved in the file at 'path'. Returns NULL in the case
+of an error, or if the file is not a valid snapshot.*/
+hash_snapshot_t *hash_snapshot_open(const char *path);
+
+/*Returns the encoded data associated with the given key, and saves its
+number of bytes in 'length' (if it is not NULL). Returns NULL if the key is
+not in the snapshot. The data is valid until the snapshot is closed.*/
+const void *hash_snapshot_get(const hash_snapshot_t *snapshot, const char *key, size_t *length);
+
+/*Returns true if the key is in the snapshot.*/
+bool hash_snapshot_is_in(const hash_snapshot_t *snapshot, const char *key);
+
+/*Same as hash_snapshot_get and hash_snapshot_is_in, with a key of
+'key_length' bytes.*/
+const void *hash_snapshot_get_bytes(const hash_snapshot_t *snapshot, const void *key, size_t key_length, size_t *length);
+bool hash_snapshot_is_in_bytes(const hash_snapshot_t *snapshot, const void *key, size_t key_length);
+
+/*Same as hash_snapshot_get and hash_snapshot_is_in, with an integer key.*/
+const void *hash_snapshot_get_int(const hash_snapshot_t *snapshot, uint64_t key, size_t *length);
+bool hash_snapshot_is_in_int(const hash_snapshot_t *snapshot, uint64_t key);
+
+/*Returns the number of elements in the snapshot.*/
+size_t hash_snapshot_size(const hash_snapshot_t *snapshot);
+
+/*Closes the snapshot.*/
+void hash_snapshot_close(hash_snapshot_t *snapshot);
+
+#endif // HASH_SNAPSHOT_H
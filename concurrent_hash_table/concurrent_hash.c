@@ -0,0 +1,370 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "concurrent_hash.h"
+#include "hash_function.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define INITIAL_CAPACITY 128
+#define INCREASEMENT_COEFICIENT 2
+#define REDUCTION_COEFICIENT 0.25
+#define INCRESEMENT_FACTOR 2
+#define REDUCTION_FACTOR 0.5
+#define STRIPES 64
+#define CACHE_LINE 64
+
+/*******************************************************************
+ * Structures
+ ******************************************************************/
+
+/*The key is stored at the end of the field, in the same allocation, and
+its full hash is kept to find the bucket of the field after a resize.
+Fields of the same bucket are chained through 'next'.*/
+typedef struct hash_field{
+	struct hash_field* next;
+	void* value;
+	uint64_t hash;
+	char key[];
+}hash_field_t;
+
+/*Each stripe takes a whole cache line, so threads working on different
+stripes do not slow each other down.*/
+typedef struct hash_stripe{
+	_Alignas(CACHE_LINE) pthread_rwlock_t lock;
+	atomic_size_t items;
+}hash_stripe_t;
+
+/*Bucket i belongs to stripe i % STRIPES. Since the size is a power of two
+(never smaller than STRIPES), the stripe of a key does not change when the
+table is resized.
+'table' and 'size' can be read while holding any stripe, and are only
+changed while holding all of them.*/
+struct hash {
+	hash_field_t** table;
+	size_t size;
+	hash_stripe_t* stripes;
+	hash_destroy_data_t destroy_data;
+};
+
+struct hash_iter{
+	const hash_t* hash;
+	hash_field_t* current;
+	size_t current_pos;
+};
+
+/******************************************************************
+ * Auxiliary Functions
+ ******************************************************************/
+
+/*Returns the hash of the given key.*/
+uint64_t get_hash(const char* key){
+	return hash_function_wyhash(key, strlen(key));
+}
+
+/*Returns the stripe of the given hash.*/
+hash_stripe_t* get_stripe(const hash_t* hash, uint64_t key_hash){
+	return &hash->stripes[key_hash & (STRIPES - 1)];
+}
+
+/*Locks every stripe (in order, so resizes never deadlock each other).*/
+void hash_lock_all(const hash_t* hash, bool write){
+	for(size_t i=0; i<STRIPES; i++){
+		if(write){
+			pthread_rwlock_wrlock(&hash->stripes[i].lock);
+		}
+
+		else{
+			pthread_rwlock_rdlock(&hash->stripes[i].lock);
+		}
+	}
+}
+
+void hash_unlock_all(const hash_t* hash){
+	for(size_t i=0; i<STRIPES; i++){
+		pthread_rwlock_unlock(&hash->stripes[i].lock);
+	}
+}
+
+/*Returns the sum of the elements of every stripe.*/
+size_t hash_count(const hash_t* hash){
+	size_t items = 0;
+
+	for(size_t i=0; i<STRIPES; i++){
+		items += atomic_load_explicit(&hash->stripes[i].items, memory_order_relaxed);
+	}
+
+	return items;
+}
+
+/*Resizes the hash table from 'old_size' to 'new_size' (powers of two),
+moving the existing fields to their new buckets. Nothing is done if
+another thread already resized the table. Returns false in case of an
+error. */
+bool hash_redimensionar(hash_t* hash, size_t old_size, size_t new_size){
+	bool ok = true;
+	hash_lock_all(hash, true);
+
+	if(hash->size != old_size){
+		hash_unlock_all(hash);
+		return true;
+	}
+
+	hash_field_t** table = calloc(new_size, sizeof(hash_field_t*));
+
+	if(!table){
+		ok = false;
+	}
+
+	else{
+		for(size_t i=0; i<old_size; i++) {
+			hash_field_t* field = hash->table[i];
+
+			while(field){
+				hash_field_t* next = field->next;
+				field->next = table[field->hash & (new_size - 1)];
+				table[field->hash & (new_size - 1)] = field;
+				field = next;
+			}
+		}
+
+		free(hash->table);
+		hash->table = table;
+		hash->size = new_size;
+	}
+
+	hash_unlock_all(hash);
+	return ok;
+}
+
+/*Returns the link (bucket or 'next' of the previous field) that points to
+the field with the given key, or to NULL if it is not there. The stripe of
+the key must be held.*/
+hash_field_t** hash_find_link(const hash_t* hash, uint64_t key_hash, const char* key){
+	hash_field_t** link = &hash->table[key_hash & (hash->size - 1)];
+
+	while(*link && ((*link)->hash != key_hash || strcmp((*link)->key, key) != 0)){
+		link = &(*link)->next;
+	}
+
+	return link;
+}
+
+/* Moves the iterator to the first field of the next non-empty bucket,
+starting from the current position.*/
+void hash_iter_next_bucket(hash_iter_t* iter){
+	while(iter->current_pos < iter->hash->size && !iter->hash->table[iter->current_pos]){
+		iter->current_pos += 1;
+	}
+
+	if(iter->current_pos < iter->hash->size){
+		iter->current = iter->hash->table[iter->current_pos];
+	}
+
+	else{
+		iter->current = NULL;
+	}
+}
+
+/******************************************************************
+ * Primitives
+ ******************************************************************/
+
+/*Hash table*/
+
+hash_t *hash_create(hash_destroy_data_t destroy_data){
+	hash_t* hash = malloc(sizeof(hash_t));
+
+	if(!hash) {
+		return NULL;
+	}
+
+	hash->size = INITIAL_CAPACITY;
+	hash->destroy_data = destroy_data;
+	hash->table = calloc(hash->size, sizeof(hash_field_t*));
+	hash->stripes = aligned_alloc(CACHE_LINE, sizeof(hash_stripe_t) * STRIPES);
+
+	if(!hash->table || !hash->stripes) {
+		free(hash->table);
+		free(hash->stripes);
+		free(hash);
+		return NULL;
+	}
+
+	for(size_t i=0; i<STRIPES; i++){
+		pthread_rwlock_init(&hash->stripes[i].lock, NULL);
+		atomic_init(&hash->stripes[i].items, 0);
+	}
+
+	return hash;
+}
+
+void hash_destroy(hash_t *hash){
+	for(size_t i=0; i<hash->size; i++) {
+		hash_field_t* field = hash->table[i];
+
+		while(field){
+			hash_field_t* next = field->next;
+
+			if(hash->destroy_data) {
+				hash->destroy_data(field->value);
+			}
+
+			free(field);
+			field = next;
+		}
+	}
+
+	for(size_t i=0; i<STRIPES; i++){
+		pthread_rwlock_destroy(&hash->stripes[i].lock);
+	}
+
+	free(hash->stripes);
+	free(hash->table);
+	free(hash);
+}
+
+bool hash_is_included(const hash_t *hash, const char *key){
+	uint64_t key_hash = get_hash(key);
+	hash_stripe_t* stripe = get_stripe(hash, key_hash);
+	pthread_rwlock_rdlock(&stripe->lock);
+	bool is_included = *hash_find_link(hash, key_hash, key) != NULL;
+	pthread_rwlock_unlock(&stripe->lock);
+	return is_included;
+}
+
+size_t hash_size(const hash_t *hash){
+	return hash_count(hash);
+}
+
+void *hash_remove(hash_t *hash, const char *key){
+	uint64_t key_hash = get_hash(key);
+	hash_stripe_t* stripe = get_stripe(hash, key_hash);
+	pthread_rwlock_wrlock(&stripe->lock);
+	hash_field_t** link = hash_find_link(hash, key_hash, key);
+	hash_field_t* field = *link;
+	void* value = NULL;
+	size_t size = hash->size;
+	bool shrink = false;
+
+	if(field) {
+		value = field->value;
+		*link = field->next;
+		free(field);
+		size_t items = atomic_fetch_sub_explicit(&stripe->items, 1, memory_order_relaxed) - 1;
+		shrink = size > INITIAL_CAPACITY && (double)items <= REDUCTION_COEFICIENT * (double)(size / STRIPES);
+	}
+
+	pthread_rwlock_unlock(&stripe->lock);
+
+	/*The stripe only suggests the resize: it is done if the whole table
+	agrees.*/
+	if(shrink && (double)hash_count(hash) <= REDUCTION_COEFICIENT * (double)size) {
+		hash_redimensionar(hash, size, (size_t)((double)size * REDUCTION_FACTOR));
+	}
+
+	return value;
+}
+
+bool hash_store(hash_t *hash, const char *key, void *data){
+	uint64_t key_hash = get_hash(key);
+	hash_stripe_t* stripe = get_stripe(hash, key_hash);
+	size_t length = strlen(key);
+	hash_field_t* new_field = malloc(sizeof(hash_field_t) + length + 1); //\0
+
+	if(!new_field) {
+		return false;
+	}
+
+	memcpy(new_field->key, key, length + 1);
+	new_field->value = data;
+	new_field->hash = key_hash;
+	pthread_rwlock_wrlock(&stripe->lock);
+	hash_field_t** link = hash_find_link(hash, key_hash, key);
+	size_t size = hash->size;
+	bool grow = false;
+
+	if(*link){
+		if(hash->destroy_data){
+			hash->destroy_data((*link)->value);
+		}
+
+		(*link)->value = data;
+		pthread_rwlock_unlock(&stripe->lock);
+		free(new_field);
+		return true;
+	}
+
+	new_field->next = NULL;
+	*link = new_field;
+	size_t items = atomic_fetch_add_explicit(&stripe->items, 1, memory_order_relaxed) + 1;
+	grow = (double)items >= INCREASEMENT_COEFICIENT * (double)(size / STRIPES);
+	pthread_rwlock_unlock(&stripe->lock);
+
+	if(grow && (double)hash_count(hash) >= INCREASEMENT_COEFICIENT * (double)size) {
+		hash_redimensionar(hash, size, size * INCRESEMENT_FACTOR);
+	}
+
+	return true;
+}
+
+void *hash_get(const hash_t *hash, const char *key){
+	uint64_t key_hash = get_hash(key);
+	hash_stripe_t* stripe = get_stripe(hash, key_hash);
+	pthread_rwlock_rdlock(&stripe->lock);
+	hash_field_t* field = *hash_find_link(hash, key_hash, key);
+	void* value = field ? field->value : NULL;
+	pthread_rwlock_unlock(&stripe->lock);
+	return value;
+}
+
+/*Iterator*/
+
+void hash_iter_destroy(hash_iter_t* iter){
+	hash_unlock_all(iter->hash);
+	free(iter);
+}
+
+hash_iter_t *hash_iter_create(const hash_t *hash){
+	hash_iter_t* iter = malloc(sizeof(hash_iter_t));
+
+	if(!iter) {
+		return NULL;
+	}
+
+	hash_lock_all(hash, false);
+	iter->hash = hash;
+	iter->current_pos = 0;
+	hash_iter_next_bucket(iter);
+	return iter;
+}
+
+bool hash_iter_at_end(const hash_iter_t *iter){
+	return !iter->current;
+}
+
+const char *hash_iter_get_current(const hash_iter_t *iter){
+	if(hash_iter_at_end(iter)) {
+		return NULL;
+	}
+
+	return iter->current->key;
+}
+
+bool hash_iter_next(hash_iter_t *iter){
+
+	if(hash_iter_at_end(iter)) {
+		return false;
+	}
+
+	iter->current = iter->current->next;
+
+	if(!iter->current){
+		iter->current_pos += 1;
+		hash_iter_next_bucket(iter);
+	}
+
+	return true;
+}
@@ -0,0 +1,86 @@
+#ifndef HASH_H
+#define HASH_H
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+Thread-safe hash table ("Dictionary") with open addressing. It is a
+separate implementation (not built on the open hash table), and it only
+has the basic interface of the open hash table: creation, hash_store,
+hash_remove, hash_get, hash_is_included, hash_size, hash_destroy and the
+iterator with string keys. There are no '_bytes' or '_int' keys, no
+capacity, reserve or load factor functions, no custom hashing or
+comparison functions, and no move to front (searches only take a read
+lock, so they cannot reorder the chains).
+Buckets are split into stripes, each one protected by a readers-writer
+lock: searches of different keys (and of the same key) run in parallel,
+and stores or removals only block the stripe of their key. Resizing takes
+every stripe.
+Needs the hashing functions and POSIX threads to work.
+*/
+
+/*******************************************************************
+ * Structures				
+ ******************************************************************/
+
+struct hash;
+struct hash_iter;
+
+typedef struct hash hash_t;
+typedef struct hash_iter hash_iter_t;
+typedef void (*hash_destroy_data_t)(void *);
+
+/*******************************************************************
+ * Primitives				
+ ******************************************************************/
+
+/*Hash table*/
+
+/*Creates a new empty hash table.*/
+hash_t *hash_create(hash_destroy_data_t destroy_data);
+
+/* Stores a new element in the hash table.
+If the given key exists in the hash table, it is replaced.
+Returns false if there was an error.*/
+bool hash_store(hash_t *hash, const char *key, void *data);
+
+/*Removes an element from the hash table and returns its data.*/
+void *hash_remove(hash_t *hash, const char *key);
+
+/*Returns the data of the element in the hash  table associated with
+the given key. */
+void *hash_get(const hash_t *hash, const char *key);
+
+/*Returns 'true' if the given key is in the hash table.*/
+bool hash_is_included(const hash_t *hash, const char *key);
+
+/*Returns the number of elements in the hash table (if other threads are
+modifying it, the result may already be outdated).*/
+size_t hash_size(const hash_t *hash);
+
+/*Destroys the hash table and every element on it (whit the provided data 
+destroying function). No other thread may be using it.*/
+void hash_destroy(hash_t *hash);
+
+/*Iterator*/
+
+/*Creates a new hash table iterator. While the iterator exists, the hash
+table can be searched by any thread, but every store or removal waits
+until the iterator is destroyed (so it must not be done by the thread
+that created the iterator).*/
+hash_iter_t *hash_iter_create(const hash_t *hash);
+
+/*Moves the iterator to the next element in the hash table.*/
+bool hash_iter_next(hash_iter_t *iter);
+
+/*Returns the current key.*/ 
+const char *hash_iter_get_current(const hash_iter_t *iter);
+
+/*Returns true if the iterator is at the end of the hash table
+(cannot move forward).*/
+bool hash_iter_at_end(const hash_iter_t *iter);
+
+/*Destroys the iterator.*/
+void hash_iter_destroy(hash_iter_t* iter);
+
+#endif // HASH_H
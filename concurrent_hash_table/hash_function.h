@@ -0,0 +1,33 @@
+#ifndef HASH_FUNCTION_H
+#define HASH_FUNCTION_H
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+Hashing functions for the hash tables.
+Every function receives a key of 'length' bytes and returns a 64 bits
+hash, which the table reduces to its (power of two) capacity.
+*/
+
+/*******************************************************************
+ *Structures				
+ ******************************************************************/
+
+typedef uint64_t (*hash_function_t)(const void *key, size_t length);
+
+/*******************************************************************
+ *Primitives			
+ ******************************************************************/
+
+/*Hashing function based on wyhash (https://github.com/wangyi-fudan/wyhash).
+Reads the key 8 bytes at a time. Used by default by the hash tables.*/
+uint64_t hash_function_wyhash(const void *key, size_t length);
+
+/*Bernstein's hashing function (djb2), computed in 64 bits.*/
+uint64_t hash_function_bernstein(const void *key, size_t length);
+
+/*Hashing function from "The C Programming Language" (Kernighan & Ritchie),
+computed in 64 bits.*/
+uint64_t hash_function_kr(const void *key, size_t length);
+
+#endif // HASH_FUNCTION_H
@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "epoch.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#define CACHE_LINE 64
+#define RETIRED_THRESHOLD 64
+#define QUIESCENT 0
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+/*Registration of a thread. 'epoch' is the global epoch seen when the
+thread entered its read section (QUIESCENT if it is outside of one).
+Retired memory is kept in the order it was retired (so in increasing
+epochs). Records are never freed: the one of a thread that exits is
+reused by another thread, along with the memory it still has to destroy.*/
+typedef struct epoch_record{
+	_Alignas(CACHE_LINE) atomic_uint_fast64_t epoch;
+	atomic_bool in_use;
+	epoch_retired_t* first;
+	epoch_retired_t* last;
+	size_t retired;
+	struct epoch_record* next;
+}epoch_record_t;
+
+/*The global epoch starts at 1, so it never looks QUIESCENT.*/
+static atomic_uint_fast64_t global_epoch = 1;
+static _Atomic(epoch_record_t*) records = NULL;
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t key;
+
+static _Thread_local epoch_record_t* local_record = NULL;
+static _Thread_local size_t local_nesting = 0;
+
+/*******************************************************************
+ *Auxiliary Functions
+ ******************************************************************/
+
+/*Advances the global epoch if every thread in a read section has already
+seen it. Returns the global epoch.*/
+uint_fast64_t epoch_try_advance(void){
+	uint_fast64_t epoch = atomic_load(&global_epoch);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	for(epoch_record_t* record = atomic_load(&records); record; record = record->next){
+		uint_fast64_t seen = atomic_load_explicit(&record->epoch, memory_order_acquire);
+
+		if(seen != QUIESCENT && seen != epoch){
+			return epoch;
+		}
+	}
+
+	if(atomic_compare_exchange_strong(&global_epoch, &epoch, epoch + 1)){
+		return epoch + 1;
+	}
+
+	return epoch;
+}
+
+/*Destroys the memory of the record that was retired at least two epochs
+before the given one: any thread that could read it has left its read
+section since.*/
+void epoch_collect(epoch_record_t* record, uint_fast64_t epoch){
+	while(record->first && record->first->epoch + 2 <= epoch){
+		epoch_retired_t* retired = record->first;
+		record->first = retired->next;
+		record->retired--;
+
+		/*The node may be part of the memory being destroyed.*/
+		bool allocated = retired->allocated;
+		retired->destroy(retired->pointer);
+
+		if(allocated){
+			free(retired);
+		}
+	}
+
+	if(!record->first){
+		record->last = NULL;
+	}
+}
+
+/*Called when a registered thread exits.*/
+void epoch_release(void* record_pointer){
+	epoch_record_t* record = record_pointer;
+	epoch_collect(record, epoch_try_advance());
+	atomic_store(&record->in_use, false);
+}
+
+void epoch_create_key(void){
+	pthread_key_create(&key, epoch_release);
+}
+
+/*Returns the record of the current thread, registering it if needed
+(NULL in the case of an error).*/
+epoch_record_t* epoch_get_record(void){
+	if(local_record){
+		return local_record;
+	}
+
+	if(pthread_once(&key_once, epoch_create_key) != 0){
+		return NULL;
+	}
+
+	epoch_record_t* record;
+
+	for(record = atomic_load(&records); record; record = record->next){
+		bool in_use = false;
+
+		if(atomic_compare_exchange_strong(&record->in_use, &in_use, true)){
+			break;
+		}
+	}
+
+	if(!record){
+		record = aligned_alloc(CACHE_LINE, sizeof(epoch_record_t));
+
+		if(!record){
+			return NULL;
+		}
+
+		atomic_init(&record->epoch, QUIESCENT);
+		atomic_init(&record->in_use, true);
+		record->first = NULL;
+		record->last = NULL;
+		record->retired = 0;
+		record->next = atomic_load(&records);
+
+		while(!atomic_compare_exchange_weak(&records, &record->next, record));
+	}
+
+	if(pthread_setspecific(key, record) != 0){
+		atomic_store(&record->in_use, false);
+		return NULL;
+	}
+
+	local_record = record;
+	return record;
+}
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+bool epoch_pin(void){
+	epoch_record_t* record = epoch_get_record();
+
+	if(!record){
+		return false;
+	}
+
+	if(local_nesting++ == 0){
+		atomic_store_explicit(&record->epoch, atomic_load(&global_epoch), memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+	}
+
+	return true;
+}
+
+void epoch_unpin(void){
+	if(--local_nesting == 0){
+		atomic_store_explicit(&local_record->epoch, QUIESCENT, memory_order_release);
+	}
+}
+
+void epoch_retire(epoch_retired_t *retired, void *pointer, epoch_destroy_t destroy, bool allocated){
+	epoch_record_t* record = local_record;
+	retired->next = NULL;
+	retired->pointer = pointer;
+	retired->destroy = destroy;
+	retired->allocated = allocated;
+	retired->epoch = atomic_load(&global_epoch);
+
+	if(record->last){
+		record->last->next = retired;
+	}
+
+	else{
+		record->first = retired;
+	}
+
+	record->last = retired;
+
+	if(++record->retired >= RETIRED_THRESHOLD){
+		epoch_collect(record, epoch_try_advance());
+	}
+}
+
+void epoch_flush(void){
+	epoch_record_t* own = epoch_get_record();
+	uint_fast64_t epoch = epoch_try_advance();
+	epoch = epoch_try_advance();
+
+	for(epoch_record_t* record = atomic_load(&records); record; record = record->next){
+		bool in_use = false;
+
+		if(record == own){
+			epoch_collect(record, epoch);
+		}
+
+		/*Records of threads that exited are adopted while collecting.*/
+		else if(atomic_compare_exchange_strong(&record->in_use, &in_use, true)){
+			epoch_collect(record, epoch);
+			atomic_store(&record->in_use, false);
+		}
+	}
+}
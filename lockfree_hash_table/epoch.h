@@ -0,0 +1,55 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+Epoch based reclamation: memory that other threads may still be reading is
+retired instead of freed, and it is only destroyed once every thread that
+could have seen it has left its read section.
+A thread reads shared memory only between epoch_pin and epoch_unpin (these
+can be nested). Each thread is registered the first time it pins, and
+unregistered when it exits.
+Needs POSIX threads to work.
+*/
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+typedef void (*epoch_destroy_t)(void *);
+
+/*Pending destruction of 'pointer'. It can be part of the retired memory
+itself (then 'allocated' is false), or be allocated with malloc (then it is
+freed after destroying the pointer).*/
+typedef struct epoch_retired{
+	struct epoch_retired* next;
+	void* pointer;
+	epoch_destroy_t destroy;
+	uint64_t epoch;
+	bool allocated;
+}epoch_retired_t;
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+/*Starts a read section of the current thread. Returns false in the case
+of an error (the thread could not be registered).*/
+bool epoch_pin(void);
+
+/*Ends the read section of the current thread.*/
+void epoch_unpin(void);
+
+/*Destroys 'pointer' with 'destroy' (using 'retired' to keep track of it)
+once no thread can be reading it. The memory must no longer be reachable
+by threads that pin after this call. Must be called inside a read
+section.*/
+void epoch_retire(epoch_retired_t *retired, void *pointer, epoch_destroy_t destroy, bool allocated);
+
+/*Destroys all the memory retired so far that is no longer read by any
+thread. Everything is destroyed if no other thread is in a read section.
+Must be called outside a read section.*/
+void epoch_flush(void);
+
+#endif // EPOCH_H
@@ -0,0 +1,612 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "lockfree_hash.h"
+#include "hash_function.h"
+#include "epoch.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPACITY 128
+#define MAX_LOAD_NUMERATOR 3
+#define MAX_LOAD_DENOMINATOR 4
+#define COPY_CHUNK 64
+
+/*Tag of a slot that was already copied to the next array.*/
+#define MOVED ((uintptr_t)1)
+
+/*Values of an entry whose key is not in the table. REMOVED entries can
+get a value again; DEAD ones were left behind by a resize.*/
+static char removed_marker;
+static char dead_marker;
+#define REMOVED ((void*)&removed_marker)
+#define DEAD ((void*)&dead_marker)
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+/*Only the value of an entry changes after it is stored, so the same entry
+is moved from an array to the next one when resizing, and searches on
+both arrays see the same value.*/
+typedef struct hash_entry{
+	_Atomic(void*) value;
+	uint64_t hash;
+	epoch_retired_t retired;
+	char key[];
+}hash_entry_t;
+
+/*Array of slots with linear probing. A slot holds an entry pointer, which
+never changes once set (removed keys keep their slot until the next
+resize). When resizing, every slot is tagged as MOVED (even the empty
+ones), and its entry is added to 'next' unless it was REMOVED.
+Threads claim chunks of COPY_CHUNK slots through 'claimed', and add the
+ones they finish to 'copied'.
+'used' is the number of slots with an entry.*/
+typedef struct hash_array{
+	size_t size;
+	atomic_size_t used;
+	_Atomic(struct hash_array*) next;
+	atomic_size_t claimed;
+	atomic_size_t copied;
+	epoch_retired_t retired;
+	_Atomic uintptr_t slots[];
+}hash_array_t;
+
+struct hash{
+	_Atomic(hash_array_t*) array;
+	atomic_size_t items;
+	hash_destroy_data_t destroy;
+};
+
+struct hash_iter{
+	const hash_array_t* array;
+	size_t position;
+};
+
+typedef enum{
+	SLOT_FOUND,
+	SLOT_EMPTY,
+	SLOT_MOVED
+}hash_slot_state_t;
+
+/*******************************************************************
+ *Auxiliary Functions
+ ******************************************************************/
+
+/*Hashes the key.*/
+uint64_t hashing(const char *key){
+	return hash_function_wyhash(key, strlen(key));
+}
+
+hash_entry_t* slot_entry(uintptr_t slot){
+	return (hash_entry_t*)(slot & ~MOVED);
+}
+
+/*Returns the size needed to hold the given number of elements with half
+the maximum load.*/
+size_t hash_size_for(size_t items){
+	size_t size = CAPACITY;
+
+	while(items * 2 * MAX_LOAD_DENOMINATOR >= size * MAX_LOAD_NUMERATOR){
+		size *= 2;
+	}
+
+	return size;
+}
+
+/*Allocates an empty array with the given size (a power of two).*/
+hash_array_t* hash_array_create(size_t size){
+	hash_array_t* array = malloc(sizeof(hash_array_t) + sizeof(uintptr_t) * size);
+
+	if(!array){
+		return NULL;
+	}
+
+	array->size = size;
+	atomic_init(&array->used, 0);
+	atomic_init(&array->next, NULL);
+	atomic_init(&array->claimed, 0);
+	atomic_init(&array->copied, 0);
+
+	for(size_t pos = 0; pos < size; pos++){
+		atomic_init(&array->slots[pos], 0);
+	}
+
+	return array;
+}
+
+/*Searches the key in the array. Saves in 'pos' the slot of its entry
+(SLOT_FOUND) or the empty slot where it would be stored (SLOT_EMPTY).
+SLOT_MOVED means the search has to go on in the next array (or that the
+array is full, if there is no next one).*/
+hash_slot_state_t hash_probe(const hash_array_t* array, uint64_t key_hash, const char* key, size_t* pos){
+	size_t mask = array->size - 1;
+	size_t i = key_hash & mask;
+
+	for(size_t n = 0; n < array->size; n++){
+		uintptr_t slot = atomic_load_explicit(&array->slots[i], memory_order_acquire);
+		hash_entry_t* entry = slot_entry(slot);
+
+		if(!entry){
+			*pos = i;
+			return slot & MOVED ? SLOT_MOVED : SLOT_EMPTY;
+		}
+
+		if(entry->hash == key_hash && strcmp(entry->key, key) == 0){
+			*pos = i;
+			return SLOT_FOUND;
+		}
+
+		i = (i + 1) & mask;
+	}
+
+	return SLOT_MOVED;
+}
+
+/*Adds an entry to an array that only receives copies. Returns false if
+the array is full, which does not happen when resizing, because the next
+array has at least as many slots as the one being copied (see
+hash_next_size).*/
+bool hash_insert_moved(hash_array_t* array, hash_entry_t* entry){
+	size_t mask = array->size - 1;
+	size_t pos = entry->hash & mask;
+
+	for(size_t n = 0; n < array->size; n++, pos = (pos + 1) & mask){
+		uintptr_t empty = 0;
+
+		if(atomic_compare_exchange_strong(&array->slots[pos], &empty, (uintptr_t)entry)){
+			atomic_fetch_add(&array->used, 1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*Tags the slot as MOVED and copies its entry to the next array (if the
+key was removed, the entry is marked DEAD and retired instead).*/
+void hash_copy_slot(hash_array_t* array, hash_array_t* next, size_t pos){
+	uintptr_t slot = atomic_load(&array->slots[pos]);
+
+	while(!atomic_compare_exchange_weak(&array->slots[pos], &slot, slot | MOVED));
+
+	hash_entry_t* entry = slot_entry(slot);
+
+	if(!entry){
+		return;
+	}
+
+	void* removed = REMOVED;
+
+	if(atomic_compare_exchange_strong(&entry->value, &removed, DEAD)){
+		epoch_retire(&entry->retired, entry, free, false);
+		return;
+	}
+
+	hash_insert_moved(next, entry);
+}
+
+/*Helps to copy the array to the next one, waits until the copy is
+finished and returns the next array. The array that finished the copy
+replaces the current one of the hash table.*/
+hash_array_t* hash_help_resize(hash_t* hash, hash_array_t* array){
+	hash_array_t* next = atomic_load(&array->next);
+
+	for(;;){
+		size_t start = atomic_fetch_add(&array->claimed, COPY_CHUNK);
+
+		if(start >= array->size){
+			break;
+		}
+
+		size_t end = start + COPY_CHUNK < array->size ? start + COPY_CHUNK : array->size;
+
+		for(size_t pos = start; pos < end; pos++){
+			hash_copy_slot(array, next, pos);
+		}
+
+		atomic_fetch_add(&array->copied, end - start);
+	}
+
+	while(atomic_load(&array->copied) < array->size){
+		sched_yield();
+	}
+
+	hash_array_t* current = array;
+
+	if(atomic_compare_exchange_strong(&hash->array, &current, next)){
+		epoch_retire(&array->retired, array, free, false);
+	}
+
+	return next;
+}
+
+/*Returns the size of the array that replaces the given one, for the given
+number of elements.
+Every entry that is not REMOVED when its slot is copied goes to the next
+array, and while resizing REMOVED entries can get a value again (and empty
+slots get new entries), so 'items' can fall short of the copies: the next
+array also holds all the used slots within the maximum load, and is never
+smaller than the current one, which bounds the copies by its size.*/
+size_t hash_next_size(const hash_array_t* array, size_t items){
+	size_t size = hash_size_for(items);
+	size_t used = atomic_load(&array->used);
+
+	while(size < array->size || used * MAX_LOAD_DENOMINATOR > size * MAX_LOAD_NUMERATOR){
+		size *= 2;
+	}
+
+	return size;
+}
+
+/*Starts a resize of the array (unless another thread already did) and
+helps to finish it. Returns the next array, or NULL in the case of an
+error.*/
+hash_array_t* hash_resize(hash_t* hash, hash_array_t* array){
+	hash_array_t* next = atomic_load(&array->next);
+
+	if(!next){
+		next = hash_array_create(hash_next_size(array, atomic_load(&hash->items)));
+
+		if(!next){
+			return NULL;
+		}
+
+		hash_array_t* none = NULL;
+
+		if(!atomic_compare_exchange_strong(&array->next, &none, next)){
+			free(next);
+		}
+	}
+
+	return hash_help_resize(hash, array);
+}
+
+/*Searches the key. Saves its data in 'data' and returns true if it is in
+the hash table. Must be called inside a read section.*/
+bool hash_lookup(const hash_t* hash, const char* key, void** data){
+	uint64_t key_hash = hashing(key);
+	hash_array_t* array = atomic_load_explicit(&hash->array, memory_order_acquire);
+	size_t pos;
+
+	for(;;){
+		hash_slot_state_t state = hash_probe(array, key_hash, key, &pos);
+
+		if(state == SLOT_EMPTY){
+			return false;
+		}
+
+		if(state == SLOT_FOUND){
+			hash_entry_t* entry = slot_entry(atomic_load_explicit(&array->slots[pos], memory_order_acquire));
+			void* value = atomic_load_explicit(&entry->value, memory_order_acquire);
+
+			if(value == REMOVED){
+				return false;
+			}
+
+			if(value != DEAD){
+				*data = value;
+				return true;
+			}
+		}
+
+		array = atomic_load_explicit(&array->next, memory_order_acquire);
+
+		if(!array){
+			return false;
+		}
+	}
+}
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+hash_t *hash_create(hash_destroy_data_t destroy_data){
+	hash_t* hash = malloc(sizeof(hash_t));
+
+	if(!hash){
+		return NULL;
+	}
+
+	hash_array_t* array = hash_array_create(CAPACITY);
+
+	if(!array){
+		free(hash);
+		return NULL;
+	}
+
+	atomic_init(&hash->array, array);
+	atomic_init(&hash->items, 0);
+	hash->destroy = destroy_data;
+	return hash;
+}
+
+void hash_destroy(hash_t *hash){
+	hash_array_t* array = atomic_load(&hash->array);
+
+	if(atomic_load(&array->next) && epoch_pin()){
+		while(atomic_load(&array->next)){
+			array = hash_help_resize(hash, array);
+		}
+
+		epoch_unpin();
+	}
+
+	for(size_t pos = 0; pos < array->size; pos++){
+		hash_entry_t* entry = slot_entry(atomic_load(&array->slots[pos]));
+
+		if(!entry){
+			continue;
+		}
+
+		void* value = atomic_load(&entry->value);
+
+		if(value != REMOVED && value != DEAD && hash->destroy){
+			hash->destroy(value);
+		}
+
+		free(entry);
+	}
+
+	free(array);
+	free(hash);
+	epoch_flush();
+}
+
+size_t hash_size(const hash_t *hash){
+	return atomic_load_explicit(&hash->items, memory_order_relaxed);
+}
+
+bool hash_store(hash_t *hash, const char *key, void *data){
+	uint64_t key_hash = hashing(key);
+	hash_entry_t* new_entry = NULL;
+	epoch_retired_t* retired = NULL;
+
+	/*Allocated beforehand, so replacing the data cannot fail.*/
+	if(hash->destroy && !(retired = malloc(sizeof(epoch_retired_t)))){
+		return false;
+	}
+
+	if(!epoch_pin()){
+		free(retired);
+		return false;
+	}
+
+	hash_array_t* array = atomic_load(&hash->array);
+	bool stored = false;
+	size_t pos;
+
+	while(!stored && array){
+		if(atomic_load(&array->next)){
+			array = hash_help_resize(hash, array);
+			continue;
+		}
+
+		hash_slot_state_t state = hash_probe(array, key_hash, key, &pos);
+
+		if(state == SLOT_FOUND){
+			hash_entry_t* entry = slot_entry(atomic_load(&array->slots[pos]));
+			void* value = atomic_load(&entry->value);
+
+			while(value != DEAD && !atomic_compare_exchange_weak(&entry->value, &value, data));
+
+			if(value == DEAD){
+				continue;
+			}
+
+			if(value == REMOVED){
+				atomic_fetch_add(&hash->items, 1);
+			}
+
+			else if(hash->destroy){
+				epoch_retire(retired, value, hash->destroy, true);
+				retired = NULL;
+			}
+
+			stored = true;
+		}
+
+		else if(state == SLOT_MOVED ||
+		        (atomic_load(&array->used) + 1) * MAX_LOAD_DENOMINATOR > array->size * MAX_LOAD_NUMERATOR){
+			array = hash_resize(hash, array);
+		}
+
+		else{
+			if(!new_entry){
+				size_t length = strlen(key);
+				new_entry = malloc(sizeof(hash_entry_t) + length + 1);
+
+				if(!new_entry){
+					break;
+				}
+
+				memcpy(new_entry->key, key, length + 1);
+				new_entry->hash = key_hash;
+				atomic_init(&new_entry->value, data);
+			}
+
+			uintptr_t empty = 0;
+
+			if(atomic_compare_exchange_strong(&array->slots[pos], &empty, (uintptr_t)new_entry)){
+				atomic_fetch_add(&array->used, 1);
+				atomic_fetch_add(&hash->items, 1);
+				new_entry = NULL;
+				stored = true;
+			}
+		}
+	}
+
+	epoch_unpin();
+	free(new_entry);
+	free(retired);
+	return stored;
+}
+
+void *hash_remove(hash_t *hash, const char *key){
+	uint64_t key_hash = hashing(key);
+
+	if(!epoch_pin()){
+		return NULL;
+	}
+
+	hash_array_t* array = atomic_load(&hash->array);
+	void* value = REMOVED;
+	size_t pos;
+
+	while(array){
+		if(atomic_load(&array->next)){
+			array = hash_help_resize(hash, array);
+			continue;
+		}
+
+		hash_slot_state_t state = hash_probe(array, key_hash, key, &pos);
+
+		if(state == SLOT_EMPTY || (state == SLOT_MOVED && !atomic_load(&array->next))){
+			break;
+		}
+
+		if(state == SLOT_MOVED){
+			continue;
+		}
+
+		hash_entry_t* entry = slot_entry(atomic_load(&array->slots[pos]));
+		value = atomic_load(&entry->value);
+
+		while(value != DEAD && value != REMOVED && !atomic_compare_exchange_weak(&entry->value, &value, REMOVED));
+
+		if(value != DEAD){
+			break;
+		}
+	}
+
+	epoch_unpin();
+
+	if(value == REMOVED || value == DEAD){
+		return NULL;
+	}
+
+	atomic_fetch_sub(&hash->items, 1);
+	return value;
+}
+
+bool hash_retire(hash_t *hash, void *data){
+	if(!hash->destroy){
+		return true;
+	}
+
+	epoch_retired_t* retired = malloc(sizeof(epoch_retired_t));
+
+	if(!retired){
+		return false;
+	}
+
+	if(!epoch_pin()){
+		free(retired);
+		return false;
+	}
+
+	epoch_retire(retired, data, hash->destroy, true);
+	epoch_unpin();
+	return true;
+}
+
+void *hash_get(const hash_t *hash, const char *key){
+	void* data = NULL;
+
+	if(epoch_pin()){
+		hash_lookup(hash, key, &data);
+		epoch_unpin();
+	}
+
+	return data;
+}
+
+bool hash_is_in(const hash_t *hash, const char *key){
+	void* data;
+
+	if(!epoch_pin()){
+		return false;
+	}
+
+	bool is_in = hash_lookup(hash, key, &data);
+	epoch_unpin();
+	return is_in;
+}
+
+bool hash_read_begin(const hash_t *hash){
+	(void)hash;
+	return epoch_pin();
+}
+
+void hash_read_end(const hash_t *hash){
+	(void)hash;
+	epoch_unpin();
+}
+
+/*Iterator*/
+
+/*Moves the iterator forward until a slot with a key in the hash table.*/
+void hash_iter_skip(hash_iter_t* iter){
+	while(iter->position != iter->array->size){
+		hash_entry_t* entry = slot_entry(atomic_load(&iter->array->slots[iter->position]));
+
+		if(entry){
+			void* value = atomic_load(&entry->value);
+
+			if(value != REMOVED && value != DEAD){
+				return;
+			}
+		}
+
+		iter->position++;
+	}
+}
+
+hash_iter_t *hash_iter_create(const hash_t *hash){
+	hash_iter_t* iter = malloc(sizeof(hash_iter_t));
+
+	if(!iter){
+		return NULL;
+	}
+
+	if(!epoch_pin()){
+		free(iter);
+		return NULL;
+	}
+
+	iter->array = atomic_load(&hash->array);
+	iter->position = 0;
+	hash_iter_skip(iter);
+	return iter;
+}
+
+bool hash_iter_at_end(const hash_iter_t *iter){
+	return (iter->position == iter->array->size);
+}
+
+bool hash_iter_next(hash_iter_t *iter){
+	if(hash_iter_at_end(iter)){
+		return false;
+	}
+
+	iter->position++;
+	hash_iter_skip(iter);
+	return true;
+}
+
+const char *hash_iter_get_current(const hash_iter_t *iter){
+	if(hash_iter_at_end(iter)){
+		return NULL;
+	}
+
+	return slot_entry(atomic_load(&iter->array->slots[iter->position]))->key;
+}
+
+void hash_iter_destroy(hash_iter_t* iter){
+	epoch_unpin();
+	free(iter);
+}
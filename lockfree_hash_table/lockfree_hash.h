@@ -0,0 +1,92 @@
+#ifndef HASH_H
+#define HASH_H
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+Thread-safe hash table ("Dictionary") with closed addressing (same
+interface as the closed hash table), meant for workloads that mostly read.
+It takes no locks: searches never wait, and stores and removals only wait
+for a resize in progress, which they help to finish.
+Memory that searches may still be reading (removed keys, replaced data and
+old arrays) is destroyed only once they are done with it.
+Only strings are allowed as keys.
+Needs the hashing functions and POSIX threads to work.
+*/
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+struct hash;
+struct hash_iter;
+typedef struct hash hash_t;
+typedef struct hash_iter hash_iter_t;
+typedef void (*hash_destroy_data_t)(void *);
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+/*Hash table*/
+
+/*Creates a new hash table.*/
+hash_t *hash_create(hash_destroy_data_t destroy_data);
+
+/*Stores a new element in the hash table. If the key already exists, its
+data is replaced, and the old one is destroyed once no thread can be
+reading it. Returns false in the case of an error.*/
+bool hash_store(hash_t *hash, const char *key, void *data);
+
+/*Removes an element from the hash table, and returns its data. Other
+threads may still be reading it: use hash_retire to destroy it.*/
+void *hash_remove(hash_t *hash, const char *key);
+
+/*Destroys the data (with the function given to hash_create) once no
+thread can be reading it. Returns false in the case of an error.*/
+bool hash_retire(hash_t *hash, void *data);
+
+/*Returns the data associated with the given key. The data can be used
+until the end of the read section that contains the call (see
+hash_read_begin), since other threads may replace or retire it.*/
+void *hash_get(const hash_t *hash, const char *key);
+
+/*Returns true if the key is in the hash table.*/
+bool hash_is_in(const hash_t *hash, const char *key);
+
+/*Starts a read section of the current thread: data got with hash_get
+inside it is not destroyed until hash_read_end is called. Read sections
+can be nested. Returns false in the case of an error.*/
+bool hash_read_begin(const hash_t *hash);
+
+/*Ends the read section of the current thread.*/
+void hash_read_end(const hash_t *hash);
+
+/*Returns the number of elements in the hash table.*/
+size_t hash_size(const hash_t *hash);
+
+/*Destroys the hash table. No other thread can be using it.*/
+void hash_destroy(hash_t *hash);
+
+/*Iterator*/
+
+/*Creates an iterator. It goes through the elements that were in the hash
+table when it was created, and may or may not see later changes. It is a
+read section until it is destroyed, so it must be used and destroyed by
+the thread that created it.*/
+hash_iter_t *hash_iter_create(const hash_t *hash);
+
+/*Moves the iterator to the next element in the hash.
+Returns false if it is not possible to move forward*/
+bool hash_iter_next(hash_iter_t *iter);
+
+/*Returns the key of the current element being iterated.*/
+const char *hash_iter_get_current(const hash_iter_t *iter);
+
+/*Returns true if the iterator won't move any further.*/
+bool hash_iter_at_end(const hash_iter_t *iter);
+
+/*Destroys the iterator*/
+void hash_iter_destroy(hash_iter_t* iter);
+
+#endif // HASH_H
@@ -0,0 +1,135 @@
+#include "hash_function.h"
+#include <string.h>
+
+#define WY_SECRET_0 0xa0761d6478bd642fULL
+#define WY_SECRET_1 0xe7037ed1a0b428dbULL
+#define WY_SECRET_2 0x8ebc6af09c88c6e3ULL
+#define WY_SECRET_3 0x589965cc75374cc3ULL
+
+/*******************************************************************
+ *Auxiliary Functions				
+ ******************************************************************/
+
+/*Multiplies 'a' and 'b' (128 bits result), leaving the lower half in 'a'
+and the upper half in 'b'.*/
+void wy_mum(uint64_t* a, uint64_t* b){
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = (__uint128_t)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/*Multiplies 'a' and 'b', and folds the result into 64 bits.*/
+uint64_t wy_mix(uint64_t a, uint64_t b){
+	wy_mum(&a, &b);
+	return a ^ b;
+}
+
+/*Reads 8 bytes (little endian).*/
+uint64_t wy_read8(const uint8_t* p){
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/*Reads 4 bytes (little endian).*/
+uint64_t wy_read4(const uint8_t* p){
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/*Reads 1 to 3 bytes.*/
+uint64_t wy_read3(const uint8_t* p, size_t length){
+	return (((uint64_t)p[0]) << 16) | (((uint64_t)p[length >> 1]) << 8) | p[length - 1];
+}
+
+/*******************************************************************
+ *Primitives				
+ ******************************************************************/
+
+uint64_t hash_function_wyhash(const void *key, size_t length){
+	const uint8_t* p = key;
+	uint64_t seed = wy_mix(WY_SECRET_0, WY_SECRET_1);
+	uint64_t a, b;
+
+	if(length <= 16){
+		if(length >= 4){
+			a = (wy_read4(p) << 32) | wy_read4(p + ((length >> 3) << 2));
+			b = (wy_read4(p + length - 4) << 32) | wy_read4(p + length - 4 - ((length >> 3) << 2));
+		}
+
+		else if(length > 0){
+			a = wy_read3(p, length);
+			b = 0;
+		}
+
+		else{
+			a = b = 0;
+		}
+	}
+
+	else{
+		size_t i = length;
+
+		if(i > 48){
+			uint64_t see1 = seed, see2 = seed;
+
+			do{
+				seed = wy_mix(wy_read8(p) ^ WY_SECRET_1, wy_read8(p + 8) ^ seed);
+				see1 = wy_mix(wy_read8(p + 16) ^ WY_SECRET_2, wy_read8(p + 24) ^ see1);
+				see2 = wy_mix(wy_read8(p + 32) ^ WY_SECRET_3, wy_read8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			}while(i > 48);
+
+			seed ^= see1 ^ see2;
+		}
+
+		while(i > 16){
+			seed = wy_mix(wy_read8(p) ^ WY_SECRET_1, wy_read8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+
+		a = wy_read8(p + i - 16);
+		b = wy_read8(p + i - 8);
+	}
+
+	a ^= WY_SECRET_1;
+	b ^= seed;
+	wy_mum(&a, &b);
+	return wy_mix(a ^ WY_SECRET_0 ^ length, b ^ WY_SECRET_1);
+}
+
+uint64_t hash_function_bernstein(const void *key, size_t length){
+	const unsigned char* str = key;
+	uint64_t nhash = 5381;
+
+	for(size_t i = 0; i < length; i++){
+		nhash = ((nhash << 5) + nhash) + str[i]; /* hash * 33 + c */
+	}
+
+	return nhash;
+}
+
+uint64_t hash_function_kr(const void *key, size_t length){
+	const unsigned char* str = key;
+	uint64_t hashval = 0;
+
+	for(size_t i = 0; i < length; i++){
+		hashval = str[i] + 31 * hashval;
+	}
+
+	return hashval;
+}
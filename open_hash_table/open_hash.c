@@ -1,9 +1,9 @@
 #include "open_hash.h"
-#include "list.h"
+#include "hash_function.h"
 #include <string.h>
 #include <stdlib.h>
 
-#define INITIAL_CAPACITY 101 
+#define INITIAL_CAPACITY 128 
 #define INCREASEMENT_COEFICIENT 2 
 #define REDUCTION_COEFICIENT 0.25 
 #define INCRESEMENT_FACTOR 2 
@@ -13,23 +13,42 @@
  * Structures				
  ******************************************************************/
 
+/*The key is stored at the end of the field, in the same allocation
+(followed by a '\0', so string keys can be returned as they are), and
+its full hash is kept to find the bucket of the field after a resize.
+Fields of the same bucket are chained through 'next'.*/
+typedef struct hash_field{
+	struct hash_field* next;
+	void* value;
+	uint64_t hash;
+	size_t length;
+	char key[];
+}hash_field_t;
+
+/*Every bucket of 'table' is the first field of its chain (NULL if
+the bucket is empty).
+The table grows when the number of elements per bucket reaches
+'max_load', and shrinks when it falls to 'min_load', but never below
+'min_size' buckets.
+If 'move_to_front' is set, a field that is found (by a search or by a
+store that replaces its data) is moved to the beginning of its chain.*/
 struct hash {
-    list_t** table;
+    hash_field_t** table;
     size_t items;
     size_t size;
+	hash_function_t hash_function;
+	hash_key_equal_t key_equal;
 	hash_destroy_data_t destroy_data;
+	double max_load;
+	double min_load;
+	size_t min_size;
+	bool move_to_front;
 };
 
-typedef struct hash_field{
-	char* key;
-	void* value;
-}hash_field_t; 
-
 struct hash_iter{
 	const hash_t* hash;
-	list_iter_t* list_iter;
+	hash_field_t* current;
 	size_t current_pos;
-	size_t iterated;
 };
 
 /******************************************************************
@@ -42,19 +61,36 @@ double get_coeficient(hash_t* hash){
 	return items / size;
 }
 
-/* Hashing function based on the one from: 
-"The C Programming Language: Second Edition", Brian Kenighan & Dennis Ritchie 
-(6.6, page 118) - Prentice Hall, 1988.
-"This is not the best possible hash function, but it is short and effective."
-*/
-size_t get_hash(const char* key, size_t size){
-	unsigned hashval;
-	
-	for (hashval = 0; *key != '\0'; key++){
-		hashval = (unsigned int) *key + 31 * hashval;
+/*Returns the hash of the given key. Its bucket is given by the lower bits
+(the size is always a power of two).*/
+uint64_t get_hash(const hash_t* hash, const void* key, size_t length){
+	return hash->hash_function(key, length);
+}
+
+/*Returns true if the field holds the given key (compared with the
+equality function of the table, if it has one).*/
+bool hash_field_matches(const hash_t* hash, const hash_field_t* field, uint64_t key_hash, const void* key, size_t length){
+	if(field->hash != key_hash || field->length != length){
+		return false;
 	}
-	
-	return hashval % size;
+
+	if(hash->key_equal){
+		return hash->key_equal(field->key, key, length);
+	}
+
+	return memcmp(field->key, key, length) == 0;
+}
+
+/*Returns the size needed to hold the given number of elements without
+reaching the maximum load.*/
+size_t get_size_for(size_t items, double max_load){
+	size_t size = INITIAL_CAPACITY;
+
+	while((double)items / (double)size >= max_load){
+		size *= INCRESEMENT_FACTOR;
+	}
+
+	return size;
 }
 
 /*Creates a new hash with an specific size.*/
@@ -68,123 +104,197 @@ hash_t* hash_create_especifico(hash_destroy_data_t destroy_data, size_t size){
 	
 	hash->size = size;
 	hash->items = 0;
+	hash->hash_function = hash_function_wyhash;
+	hash->key_equal = NULL;
 	hash->destroy_data = destroy_data;
-	hash->table = malloc(sizeof(list_t*) * hash->size);
+	hash->max_load = INCREASEMENT_COEFICIENT;
+	hash->min_load = REDUCTION_COEFICIENT;
+	hash->min_size = size;
+	hash->move_to_front = false;
+	hash->table = calloc(hash->size, sizeof(hash_field_t*));
 	
 	if(!hash->table) {	
 		free(hash); 
 		return NULL;
 	}
 	
-	for(int i=0; i<hash->size; i++){
-		hash->table[i] = list_create(); 
+	return hash;
+}
 
-		if(!hash->table[i]){
-			hash_destroy(hash); 
-			return NULL;
+/*Resizes the hash table to the specified size (a power of two), moving
+the existing fields to their new buckets: only the array of buckets is
+reallocated. Returns false in case of an error. */
+bool hash_redimensionar(hash_t* hash, double tam_new){
+	size_t new_size = (size_t) tam_new;
+	size_t mask = new_size - 1;
+	hash_field_t** table;
+
+	if(new_size > hash->size){
+		table = realloc(hash->table, sizeof(hash_field_t*) * new_size);
+
+		if(!table) {
+			return false;
+		}
+
+		memset(table + hash->size, 0, sizeof(hash_field_t*) * (new_size - hash->size));
+		hash->table = table;
+
+		/*The fields of a bucket can only go to that same bucket or to
+		the new ones (which only receive fields from it).*/
+		for(size_t i=0; i<hash->size; i++) {
+			hash_field_t* field = table[i];
+			table[i] = NULL;
+
+			while(field){
+				hash_field_t* next = field->next;
+				field->next = table[field->hash & mask];
+				table[field->hash & mask] = field;
+				field = next;
+			}
 		}
 	}
-	
-	return hash;
-}
 
-/*Destroys a hash field.*/
-void hash_field_destroy(hash_field_t* field, const hash_t* hash){
-	
-	if(hash){ 
-		if(hash->destroy_data && hash->items == hash->size){ //Removing for a replacement
-			hash->destroy_data(field->value);
+	else{
+		for(size_t i=new_size; i<hash->size; i++) {
+			hash_field_t* field = hash->table[i];
+
+			while(field){
+				hash_field_t* next = field->next;
+				field->next = hash->table[field->hash & mask];
+				hash->table[field->hash & mask] = field;
+				field = next;
+			}
+		}
+
+		table = realloc(hash->table, sizeof(hash_field_t*) * new_size);
+
+		if(table) {
+			hash->table = table;
 		}
 	}
 
-	free(field->key);
-	free(field);
+	hash->size = new_size;
+	return true;
 }
 
-void wrapper_hash_field_destroy(void * field){
-	hash_field_destroy(field, NULL);
+/*Returns the link (the pointer in the chain) to the hash field associated
+with the given key, whose hash is 'key_hash'. The link points to NULL if
+the key is not in the hash table.*/
+hash_field_t** hash_find_link(hash_t *hash, uint64_t key_hash, const void *key, size_t length){
+	hash_field_t** link = &hash->table[key_hash & (hash->size - 1)];
+
+	while(*link && !hash_field_matches(hash, *link, key_hash, key, length)){
+		link = &(*link)->next;
+	}
+
+	return link;
 }
 
-/*Recreates the hash table with the specified size. 
-Returns false in case of an error. */
-bool hash_redimensionar(hash_t* hash, double tam_new){
-	bool copy_ok = true;
-	hash_t* hash_aux = hash_create_especifico(hash->destroy_data, (size_t) tam_new);
-	
-	if(!hash_aux) {
-		return false;
+/*Moves the field that 'link' points to to the beginning of its chain, the
+one at position 'pos', if 'move_to_front' is set.*/
+void hash_move_to_front(hash_t *hash, hash_field_t** link, size_t pos){
+	hash_field_t* field = *link;
+
+	if(hash->move_to_front && link != &hash->table[pos]){
+		*link = field->next;
+		field->next = hash->table[pos];
+		hash->table[pos] = field;
 	}
-	
-	size_t old_size = hash->size;
-	hash_field_t* field = NULL;
-	list_iter_t* iter;
-	
-	for(int i=0; i<old_size && copy_ok; i++) {	
-		iter = list_iter_create(hash->table[i]);
-		
-		if(!iter) {
-			copy_ok = false; 
-			break;
-		}
-		
-		while(!list_iter_at_end(iter)){
-			field = list_iter_get_current(iter);
-			
-			if(!hash_store(hash_aux, field->key, field->value)){
-				copy_ok = false;
-				break;
-			}
-			
-			list_iter_continue(iter);
-		}
+}
 
-		list_iter_destroy(iter);
-		list_destroy(hash->table[i],wrapper_hash_field_destroy);
+/*Returns the hash field associated with the given key (moving it to the
+front, if 'move_to_front' is set).*/
+hash_field_t* hash_get_field(hash_t *hash, const void *key, size_t length){
+	uint64_t key_hash = get_hash(hash, key, length);
+	hash_field_t** link = hash_find_link(hash, key_hash, key, length);
+	hash_field_t* field = *link;
+
+	if(field){
+		hash_move_to_front(hash, link, key_hash & (hash->size - 1));
 	}
-	
-	free(hash->table);
-	hash->table = hash_aux->table;
-	hash->size = hash_aux->size;
-	free(hash_aux);
-	return copy_ok;
+
+	return field;
 }
 
-/*Returns the hash field associated with the given key*/
-hash_field_t* hash_get_field(const hash_t *hash, const char *key){
-	size_t pos = get_hash(key, hash->size);
-	list_iter_t* iter = list_iter_create(hash->table[pos]);
+/*Removes the element with a key of the given length, and returns its
+data.*/
+void* hash_remove_key(hash_t *hash, const void *key, size_t length){
+	hash_field_t** link = hash_find_link(hash, get_hash(hash, key, length), key, length);
+	hash_field_t* field = *link;
 
-	if(!iter) {
+	if(!field) {
 		return NULL;
 	}
+
+	void* value = field->value;
+	*link = field->next;
+	free(field);
+	hash->items -= 1;
 	
-	hash_field_t* field = NULL;
+	if(get_coeficient(hash) <= hash->min_load && hash->size > hash->min_size) {
+		hash_redimensionar(hash,(double)hash->size * REDUCTION_FACTOR);
+	}
 
-	while(!list_iter_at_end(iter)){
-		field = list_iter_get_current(iter);
+	return value;	
+}
 
-		if(strcmp(field->key,key) == 0) {
-			break;
+/*Stores the data with a key of the given length. Returns false in case
+of an error.*/
+bool hash_store_key(hash_t *hash, const void *key, size_t length, void *data){
+	
+	if(get_coeficient(hash) >= hash->max_load) {
+		if(!hash_redimensionar(hash,(double)hash->size * INCRESEMENT_FACTOR)){
+			return false;
 		}
-		list_iter_continue(iter);
 	}
 	
-	list_iter_destroy(iter);
+	uint64_t key_hash = get_hash(hash, key, length);
+	size_t pos = key_hash & (hash->size - 1);
+	hash_field_t** link = hash_find_link(hash, key_hash, key, length);
+	hash_field_t* existent_field = *link;
 	
-	if(!field) {
-		return NULL;
+	if(existent_field){
+		hash_move_to_front(hash, link, pos);
+
+		if(hash->destroy_data){
+			hash->destroy_data(existent_field->value);
+		}
+		
+		existent_field->value = data;
+		return true;
 	}
 	
-	return field;
+	hash_field_t* new_field = malloc(sizeof(hash_field_t) + length + 1); //\0
+
+	if(!new_field) {
+		return false;
+	}
+		
+	memcpy(new_field->key, key, length);
+	new_field->key[length] = '\0';
+	new_field->length = length;
+	new_field->value = data;
+	new_field->hash = key_hash;
+	new_field->next = hash->table[pos];
+	hash->table[pos] = new_field;
+	hash->items += 1;
+	return true;
 }
 
-/* Moves the iterator to the beginning of the hash table.*/
-void hash_iter_next_primero(hash_iter_t* iter){
-	if(!list_iter_get_current(iter->list_iter)) {
-		hash_iter_next(iter);
+/* Moves the iterator to the first field of the next non-empty bucket,
+starting from the current position.*/
+void hash_iter_next_bucket(hash_iter_t* iter){
+	while(iter->current_pos < iter->hash->size && !iter->hash->table[iter->current_pos]){
+		iter->current_pos += 1;
 	}
 	
-	iter->iterated = 0;
+	if(iter->current_pos < iter->hash->size){
+		iter->current = iter->hash->table[iter->current_pos];
+	}
+
+	else{
+		iter->current = NULL;
+	}
 }
 
 /******************************************************************
@@ -197,54 +307,103 @@ hash_t *hash_create(hash_destroy_data_t destroy_data){
 	return hash_create_especifico(destroy_data, INITIAL_CAPACITY);
 }
 
+hash_t *hash_create_with_capacity(hash_destroy_data_t destroy_data, size_t capacity){
+	return hash_create_especifico(destroy_data, get_size_for(capacity, INCREASEMENT_COEFICIENT));
+}
+
+bool hash_reserve(hash_t *hash, size_t capacity){
+	if(capacity < hash->items){
+		capacity = hash->items;
+	}
+
+	size_t size = get_size_for(capacity, hash->max_load);
+	hash->min_size = size;
+
+	if(size <= hash->size){
+		return true;
+	}
+
+	return hash_redimensionar(hash, (double)size);
+}
+
+bool hash_shrink_to_fit(hash_t *hash){
+	size_t size = get_size_for(hash->items, hash->max_load);
+	hash->min_size = INITIAL_CAPACITY;
+
+	if(size == hash->size){
+		return true;
+	}
+
+	return hash_redimensionar(hash, (double)size);
+}
+
+bool hash_set_load_factors(hash_t *hash, double max_load, double min_load){
+	if(max_load <= 0 || min_load < 0 || min_load * INCRESEMENT_FACTOR >= max_load){
+		return false;
+	}
+
+	hash->max_load = max_load;
+	hash->min_load = min_load;
+	return true;
+}
+
+void hash_set_move_to_front(hash_t *hash, bool move_to_front){
+	hash->move_to_front = move_to_front;
+}
+
 void hash_destroy(hash_t *hash){	
-	hash_field_t* field;
+	for(size_t i=0; i<hash->size; i++) {
+		hash_field_t* field = hash->table[i];
 
-	for(int i=0; i<hash->size; i++) {
-		
-		while(!list_is_empty(hash->table[i])){
-			field = list_remove_first(hash->table[i]);
+		while(field){
+			hash_field_t* next = field->next;
 
 			if(hash->destroy_data) {
 				hash->destroy_data(field->value);
 			}
 
-			free(field->key);
 			free(field);
+			field = next;
 		}
-		
-		list_destroy(hash->table[i], free);
 	}
 	
 	free(hash->table);
 	free(hash);
 }
 
-bool hash_is_included(const hash_t *hash, const char *key){
-	size_t pos = get_hash(key, hash->size);
-	list_iter_t* iter = list_iter_create(hash->table[pos]);
+void hash_destroy_keeping_data(hash_t *hash){
+	hash->destroy_data = NULL;
+	hash_destroy(hash);
+}
 
-	if(!iter) {
+bool hash_is_included(hash_t *hash, const char *key){
+	return hash_get_field(hash, key, strlen(key)) != NULL;
+}
+
+bool hash_set_hash_function(hash_t *hash, hash_function_t hash_function){
+	if(hash->items != 0){
 		return false;
 	}
-	
-	bool is_included = false;
-	hash_field_t* field;
-	
-	while(!list_iter_at_end(iter)){
-		
-		field = list_iter_get_current(iter);
-		
-		if(strcmp(field->key,key) == 0){
-			is_included = true;
-			break;
-		}
-		
-		list_iter_continue(iter);
+
+	hash->hash_function = hash_function;
+	return true;
+}
+
+bool hash_set_key_equal(hash_t *hash, hash_key_equal_t key_equal){
+	if(hash->items != 0){
+		return false;
 	}
-	
-	list_iter_destroy(iter);
-	return is_included;
+
+	hash->key_equal = key_equal;
+	return true;
+}
+
+hash_function_t hash_get_hash_function(const hash_t *hash){
+	return hash->hash_function;
+}
+
+hash_key_equal_t hash_get_key_equal(const hash_t *hash){
+	return hash->key_equal;
 }
 
 size_t hash_size(const hash_t *hash){
@@ -252,93 +411,59 @@ size_t hash_size(const hash_t *hash){
 }
 
 void *hash_remove(hash_t *hash, const char *key){
-	size_t pos = get_hash(key, hash->size);
-	list_iter_t* iter = list_iter_create(hash->table[pos]);
+	return hash_remove_key(hash, key, strlen(key));
+}
+
+bool hash_store(hash_t *hash, const char *key, void *data){
+	return hash_store_key(hash, key, strlen(key), data);
+}
+
+void *hash_get(hash_t *hash, const char *key){
+	hash_field_t* field = hash_get_field(hash, key, strlen(key));
 	
-	if(!iter) {
+	if(!field) {
 		return NULL;
 	}
-
-	hash_field_t* field;
-	void* value = NULL;
 	
-	while(!list_iter_at_end(iter)){
-		field = list_iter_get_current(iter);
-		
-		if(strcmp(field->key,key) == 0) {
-			value = field->value;
-			hash_field_destroy(list_iter_remove(iter), hash);
-			hash->items -= 1;
-			
-			if(get_coeficient(hash) <= REDUCTION_COEFICIENT) {
-				hash_redimensionar(hash,(double)hash->size * REDUCTION_FACTOR);
-			}
-
-			break;
-		}
+	return field->value;
+}
 
-		list_iter_continue(iter);
-	}
+bool hash_store_bytes(hash_t *hash, const void *key, size_t length, void *data){
+	return hash_store_key(hash, key, length, data);
+}
 
-	list_iter_destroy(iter);		
-	return value;	
+void *hash_remove_bytes(hash_t *hash, const void *key, size_t length){
+	return hash_remove_key(hash, key, length);
 }
 
-bool hash_store(hash_t *hash, const char *key, void *data){
-	
-	if(get_coeficient(hash) >= INCREASEMENT_COEFICIENT) {
-		if(!hash_redimensionar(hash,(double)hash->size * INCRESEMENT_FACTOR)){
-			return false;
-		}
-	}
-	
-	size_t pos = get_hash(key, hash->size); 
-	hash_field_t* new_field = malloc(sizeof(hash_field_t));
+void *hash_get_bytes(hash_t *hash, const void *key, size_t length){
+	hash_field_t* field = hash_get_field(hash, key, length);
+	return field ? field->value : NULL;
+}
 
-	if(!new_field) {
-		return false;
-	}
-	
-	if(hash_is_included(hash,key)){
-		hash_field_t* existent_field = hash_get_field(hash, key);
+bool hash_is_included_bytes(hash_t *hash, const void *key, size_t length){
+	return hash_get_field(hash, key, length) != NULL;
+}
 
-		if(hash->destroy_data){
-			hash->destroy_data(existent_field->value);
-		}
-		
-		existent_field->value = data;
-		free(new_field);
-	}
-	
-	else{
-		
-		new_field->key = malloc(sizeof(char) * (strlen(key)+1)); //\0
-		strcpy(new_field->key, key);
-		new_field->value = data;
+bool hash_store_int(hash_t *hash, uint64_t key, void *data){
+	return hash_store_key(hash, &key, sizeof(key), data);
+}
 
-		if(!list_add_first(hash->table[pos],new_field)) {
-			return false;
-		}
+void *hash_remove_int(hash_t *hash, uint64_t key){
+	return hash_remove_key(hash, &key, sizeof(key));
+}
 
-		hash->items += 1;
-	}
-	return true;
+void *hash_get_int(hash_t *hash, uint64_t key){
+	return hash_get_bytes(hash, &key, sizeof(key));
 }
 
-void *hash_get(const hash_t *hash, const char *key){
-	hash_field_t* field = hash_get_field(hash, key);
-	
-	if(!field) {
-		return NULL;
-	}
-	
-	return field->value;
+bool hash_is_included_int(hash_t *hash, uint64_t key){
+	return hash_get_field(hash, &key, sizeof(key)) != NULL;
 }
 
 /*Iterator*/
 
 void hash_iter_destroy(hash_iter_t* iter){	
-	list_iter_destroy(iter->list_iter);
 	free(iter);
 }
 
@@ -351,20 +476,12 @@ hash_iter_t *hash_iter_create(const hash_t *hash){
 	
 	iter->hash = hash;	
 	iter->current_pos = 0;
-	iter->iterated = 0;
-	iter->list_iter = list_iter_create(iter->hash->table[iter->current_pos]);
-	
-	if(!iter->list_iter){
-		free(iter);
-		return NULL;
-	}
-	
-	hash_iter_next_primero(iter);
+	hash_iter_next_bucket(iter);
 	return iter;
 }
 
 bool hash_iter_at_end(const hash_iter_t *iter){
-	return (iter->iterated == iter->hash->items);
+	return !iter->current;
 }
 
 const char *hash_iter_get_current(const hash_iter_t *iter){
@@ -372,7 +489,26 @@ const char *hash_iter_get_current(const hash_iter_t *iter){
 		return NULL;
 	}
 	
-	return ((hash_field_t*)list_iter_get_current(iter->list_iter))->key;
+	return iter->current->key;
+}
+
+const void *hash_iter_get_current_bytes(const hash_iter_t *iter, size_t *length){
+	if(hash_iter_at_end(iter)) {
+		return NULL;
+	}
+
+	*length = iter->current->length;
+	return iter->current->key;
+}
+
+uint64_t hash_iter_get_current_int(const hash_iter_t *iter){
+	uint64_t key = 0;
+
+	if(!hash_iter_at_end(iter) && iter->current->length >= sizeof(key)) {
+		memcpy(&key, iter->current->key, sizeof(key));
+	}
+
+	return key;
 }
 
 bool hash_iter_next(hash_iter_t *iter){
@@ -381,30 +517,12 @@ bool hash_iter_next(hash_iter_t *iter){
 		return false;
 	}
 	
-	if(!list_iter_continue(iter->list_iter)){
+	iter->current = iter->current->next;
+
+	if(!iter->current){
 		iter->current_pos += 1;
-		
-		if(iter->current_pos == iter->hash->size){
-			iter->iterated +=1;
-			return false;
-		}
-			
-		list_iter_destroy(iter->list_iter);
-		iter->list_iter = list_iter_create(iter->hash->table[iter->current_pos]);
-		
-		if(!iter->list_iter) {
-			return false;
-		}
+		hash_iter_next_bucket(iter);
 	}
 	
-	while(!list_iter_get_current(iter->list_iter) && !list_iter_at_end(iter->list_iter)){
-		list_iter_continue(iter->list_iter);
-	}
-
-	if(list_iter_at_end(iter->list_iter)){
-	   return hash_iter_next(iter);
-	}
-	   
-	iter->iterated +=1;
 	return true;
 }
\ No newline at end of file
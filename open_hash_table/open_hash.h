@@ -2,11 +2,17 @@
 #define HASH_H
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "hash_function.h"
 
 /*
 Hash table ("Dictionary") with open addressing. 
-Only strings are allowed as keys.  
-Needs the list to work.
+Keys are strings, sequences of bytes or 64 bit integers (the '_bytes' and
+'_int' variants of the primitives). An integer key is the same as its 8
+bytes.
+Every bucket is a chain of fields linked to each other, each holding
+its key, so storing a new element takes a single allocation.
+Needs the hashing functions to work.
 */
 
 /*******************************************************************
@@ -20,6 +26,9 @@ typedef struct hash hash_t;
 typedef struct hash_iter hash_iter_t;
 typedef void (*hash_destroy_data_t)(void *);
 
+/*Returns true if two keys of the given length are equal.*/
+typedef bool (*hash_key_equal_t)(const void *, const void *, size_t);
+
 /*******************************************************************
  * Primitives				
  ******************************************************************/
@@ -29,6 +38,26 @@ typedef void (*hash_destroy_data_t)(void *);
 /*Creates a new empty hash table.*/
 hash_t *hash_create(hash_destroy_data_t destroy_data);
 
+/*Creates a new empty hash table, with room for 'capacity' elements (it will
+not be resized until that many elements are stored, nor shrink below that
+size).*/
+hash_t *hash_create_with_capacity(hash_destroy_data_t destroy_data, size_t capacity);
+
+/*Makes room for 'capacity' elements: the hash table will not be resized
+until that many elements are stored, nor shrink below that size.
+Returns false if there was an error.*/
+bool hash_reserve(hash_t *hash, size_t capacity);
+
+/*Resizes the hash table to the smallest size that can hold its elements,
+and cancels any previous reservation. Returns false if there was an error.*/
+bool hash_shrink_to_fit(hash_t *hash);
+
+/*Sets the average number of elements per list at which the hash table
+grows (2 by default) and shrinks (0.25 by default). 'min_load' must be
+less than half of 'max_load', so a resize never triggers the opposite one.
+Returns false if the values are not valid.*/
+bool hash_set_load_factors(hash_t *hash, double max_load, double min_load);
+
 /* Stores a new element in the hash table.
 If the given key exists in the hash table, it is replaced.
 Returns false if there was an error.*/
@@ -39,10 +68,46 @@ void *hash_remove(hash_t *hash, const char *key);
 
 /*Returns the data of the element in the hash  table associated with
 the given key. */
-void *hash_get(const hash_t *hash, const char *key);
+void *hash_get(hash_t *hash, const char *key);
 
 /*Returns 'true' if the given key is in the hash table.*/
-bool hash_is_included(const hash_t *hash, const char *key);
+bool hash_is_included(hash_t *hash, const char *key);
+
+/*Same as hash_store, hash_remove, hash_get and hash_is_included, with a
+key of 'length' bytes (it can contain '\0').*/
+bool hash_store_bytes(hash_t *hash, const void *key, size_t length, void *data);
+void *hash_remove_bytes(hash_t *hash, const void *key, size_t length);
+void *hash_get_bytes(hash_t *hash, const void *key, size_t length);
+bool hash_is_included_bytes(hash_t *hash, const void *key, size_t length);
+
+/*Same as hash_store, hash_remove, hash_get and hash_is_included, with an
+integer key.*/
+bool hash_store_int(hash_t *hash, uint64_t key, void *data);
+void *hash_remove_int(hash_t *hash, uint64_t key);
+void *hash_get_int(hash_t *hash, uint64_t key);
+bool hash_is_included_int(hash_t *hash, uint64_t key);
+
+/*Sets the function used to hash the keys (hash_function_wyhash by default).
+Only possible while the hash table is empty: returns false otherwise.*/
+bool hash_set_hash_function(hash_t *hash, hash_function_t hash_function);
+
+/*Sets the function used to compare keys with the same hash and length
+(memcmp by default). Only possible while the hash table is empty: returns
+false otherwise.*/
+bool hash_set_key_equal(hash_t *hash, hash_key_equal_t key_equal);
+
+/*Return the functions used to hash and compare the keys. The comparison
+function is NULL if the keys are compared with memcmp.*/
+hash_function_t hash_get_hash_function(const hash_t *hash);
+hash_key_equal_t hash_get_key_equal(const hash_t *hash);
+
+/*If 'move_to_front' is true, every element that is found by a search
+(including hash_get and hash_is_included) or whose data is replaced by a
+store is moved to the beginning of its chain, so frequently used keys are
+found first. Searches then modify the hash table: they must be
+synchronized like stores, and not be done while iterating it. Disabled by
+default.*/
+void hash_set_move_to_front(hash_t *hash, bool move_to_front);
 
 /*Returns the number of elements in the hash table.*/
 size_t hash_size(const hash_t *hash);
@@ -51,6 +116,9 @@ size_t hash_size(const hash_t *hash);
 destroying function) */
 void hash_destroy(hash_t *hash);
 
+/*Destroys the hash table, but not the data of its elements.*/
+void hash_destroy_keeping_data(hash_t *hash);
+
 /*Iterator*/
 
 /*Creates a new hash table iterator*/
@@ -62,6 +130,12 @@ bool hash_iter_next(hash_iter_t *iter);
 /*Returns the current key.*/ 
 const char *hash_iter_get_current(const hash_iter_t *iter);
 
+/*Returns the current key, and saves its length in 'length'.*/
+const void *hash_iter_get_current_bytes(const hash_iter_t *iter, size_t *length);
+
+/*Returns the current integer key.*/
+uint64_t hash_iter_get_current_int(const hash_iter_t *iter);
+
 /*Returns true if the iterator is at the end of the hash table
 (cannot move forward).*/
 bool hash_iter_at_end(const hash_iter_t *iter);
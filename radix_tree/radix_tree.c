@@ -0,0 +1,941 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_tree.h"
+
+#define NODE4 0
+#define NODE16 1
+#define NODE48 2
+#define NODE256 3
+#define MAX_PREFIX 8
+#define LEAF_TAG 1
+
+/*******************************************************************
+ * Structures
+ ******************************************************************/
+
+/*Every key is followed from the root byte by byte, including its '\0'
+(so no key is the beginning of another one, and shorter keys go first).
+An inner node has the children of up to 4, 16, 48 or 256 different bytes,
+after its prefix: the 'prefix_length' bytes shared by every key below it,
+of which only the first MAX_PREFIX are kept in 'prefix' (the rest are
+read from any of those keys). Prefixes never have a '\0'.
+Children are either inner nodes or leaves, which are told apart by the
+lowest bit of the pointer (set for leaves).*/
+typedef struct art_node{
+	uint32_t prefix_length;
+	uint16_t count;
+	uint8_t type;
+	unsigned char prefix[MAX_PREFIX];
+}art_node_t;
+
+/*'keys' is sorted, and children[i] is the child of keys[i].*/
+typedef struct art_node4{
+	art_node_t node;
+	unsigned char keys[4];
+	art_node_t* children[4];
+}art_node4_t;
+
+typedef struct art_node16{
+	art_node_t node;
+	unsigned char keys[16];
+	art_node_t* children[16];
+}art_node16_t;
+
+/*The child of byte b is children[indexes[b] - 1] (none if indexes[b] is
+0). The first 'count' children are the used ones.*/
+typedef struct art_node48{
+	art_node_t node;
+	unsigned char indexes[256];
+	art_node_t* children[48];
+}art_node48_t;
+
+typedef struct art_node256{
+	art_node_t node;
+	art_node_t* children[256];
+}art_node256_t;
+
+/*Leaves are also linked in order.*/
+typedef struct art_leaf{
+	struct art_leaf* prev;
+	struct art_leaf* next;
+	void* data;
+	char key[];
+}art_leaf_t;
+
+struct bst{
+	art_node_t* root;
+	art_leaf_t* first;
+	bst_destroy_data_t destroy_data;
+	size_t items;
+};
+
+/*******************************************************************
+ * Auxiliary Functions
+ ******************************************************************/
+
+bool art_is_leaf(const art_node_t* node){
+	return (uintptr_t)node & LEAF_TAG;
+}
+
+art_leaf_t* art_node_leaf(const art_node_t* node){
+	return (art_leaf_t*)((uintptr_t)node & ~(uintptr_t)LEAF_TAG);
+}
+
+art_node_t* art_leaf_node(const art_leaf_t* leaf){
+	return (art_node_t*)((uintptr_t)leaf | LEAF_TAG);
+}
+
+/*Creates a new leaf.*/
+art_leaf_t* art_leaf_create(const char* key, void* data){
+	size_t key_size = strlen(key) + 1; //\0
+	art_leaf_t* leaf = malloc(sizeof(art_leaf_t) + key_size);
+
+	if(!leaf){
+		return NULL;
+	}
+
+	memcpy(leaf->key, key, key_size);
+	leaf->data = data;
+	leaf->prev = NULL;
+	leaf->next = NULL;
+	return leaf;
+}
+
+/*Creates a new inner node of the given type, without children.*/
+art_node_t* art_node_create(uint8_t type){
+	static const size_t sizes[] = {sizeof(art_node4_t), sizeof(art_node16_t),
+	                               sizeof(art_node48_t), sizeof(art_node256_t)};
+	art_node_t* node = calloc(1, sizes[type]);
+
+	if(!node){
+		return NULL;
+	}
+
+	node->type = type;
+	return node;
+}
+
+/*Returns the array of children of the node.*/
+art_node_t** art_node_children(art_node_t* node){
+	switch(node->type){
+		case NODE4:
+			return ((art_node4_t*)node)->children;
+
+		case NODE16:
+			return ((art_node16_t*)node)->children;
+
+		case NODE48:
+			return ((art_node48_t*)node)->children;
+
+		default:
+			return ((art_node256_t*)node)->children;
+	}
+}
+
+/*Returns the sorted array of bytes of a NODE4 or NODE16.*/
+unsigned char* art_node_keys(art_node_t* node){
+	return node->type == NODE4 ? ((art_node4_t*)node)->keys : ((art_node16_t*)node)->keys;
+}
+
+/*Returns the link to the child of the byte, or NULL if there is none.*/
+art_node_t** art_node_find_child(art_node_t* node, unsigned char byte){
+	art_node_t** children = art_node_children(node);
+
+	if(node->type == NODE48){
+		unsigned char index = ((art_node48_t*)node)->indexes[byte];
+		return index ? &children[index - 1] : NULL;
+	}
+
+	if(node->type == NODE256){
+		return children[byte] ? &children[byte] : NULL;
+	}
+
+	unsigned char* keys = art_node_keys(node);
+
+	for(size_t i = 0; i < node->count; i++){
+		if(keys[i] == byte){
+			return &children[i];
+		}
+	}
+
+	return NULL;
+}
+
+/*Returns the child of the smallest byte greater than 'byte' (which can be
+-1, to get the first child), or NULL if there is none.*/
+art_node_t* art_node_child_after(art_node_t* node, int byte){
+	art_node_t** children = art_node_children(node);
+
+	if(node->type == NODE48){
+		const unsigned char* indexes = ((art_node48_t*)node)->indexes;
+
+		for(int b = byte + 1; b < 256; b++){
+			if(indexes[b]){
+				return children[indexes[b] - 1];
+			}
+		}
+
+		return NULL;
+	}
+
+	if(node->type == NODE256){
+		for(int b = byte + 1; b < 256; b++){
+			if(children[b]){
+				return children[b];
+			}
+		}
+
+		return NULL;
+	}
+
+	unsigned char* keys = art_node_keys(node);
+
+	for(size_t i = 0; i < node->count; i++){
+		if(keys[i] > byte){
+			return children[i];
+		}
+	}
+
+	return NULL;
+}
+
+/*Returns the child of the greatest byte less than 'byte' (which can be
+256, to get the last child), or NULL if there is none.*/
+art_node_t* art_node_child_before(art_node_t* node, int byte){
+	art_node_t** children = art_node_children(node);
+
+	if(node->type == NODE48){
+		const unsigned char* indexes = ((art_node48_t*)node)->indexes;
+
+		for(int b = byte - 1; b >= 0; b--){
+			if(indexes[b]){
+				return children[indexes[b] - 1];
+			}
+		}
+
+		return NULL;
+	}
+
+	if(node->type == NODE256){
+		for(int b = byte - 1; b >= 0; b--){
+			if(children[b]){
+				return children[b];
+			}
+		}
+
+		return NULL;
+	}
+
+	unsigned char* keys = art_node_keys(node);
+
+	for(size_t i = node->count; i > 0; i--){
+		if(keys[i - 1] < byte){
+			return children[i - 1];
+		}
+	}
+
+	return NULL;
+}
+
+/*Returns the leaf with the first key of the subtree.*/
+art_leaf_t* art_first_leaf(art_node_t* node){
+	while(!art_is_leaf(node)){
+		node = art_node_child_after(node, -1);
+	}
+
+	return art_node_leaf(node);
+}
+
+/*Returns the leaf with the last key of the subtree.*/
+art_leaf_t* art_last_leaf(art_node_t* node){
+	while(!art_is_leaf(node)){
+		node = art_node_child_before(node, 256);
+	}
+
+	return art_node_leaf(node);
+}
+
+/*Returns the whole prefix of the node, which is 'depth' bytes below the
+root.*/
+const unsigned char* art_node_prefix(art_node_t* node, size_t depth){
+	if(node->prefix_length <= MAX_PREFIX){
+		return node->prefix;
+	}
+
+	return (const unsigned char*)art_first_leaf(node)->key + depth;
+}
+
+/*Saves the prefix of the node (only its first MAX_PREFIX bytes are
+kept).*/
+void art_node_set_prefix(art_node_t* node, const unsigned char* prefix, size_t length){
+	node->prefix_length = (uint32_t)length;
+	memmove(node->prefix, prefix, length < MAX_PREFIX ? length : MAX_PREFIX);
+}
+
+/*Returns the number of bytes of the node's prefix that match the key from
+position 'depth' on.*/
+size_t art_node_match_prefix(art_node_t* node, const unsigned char* key, size_t depth){
+	size_t i = 0;
+
+	for(; i < node->prefix_length && i < MAX_PREFIX; i++){
+		if(key[depth + i] != node->prefix[i]){
+			return i;
+		}
+	}
+
+	if(i == node->prefix_length){
+		return i;
+	}
+
+	const unsigned char* prefix = art_node_prefix(node, depth);
+
+	for(; i < node->prefix_length; i++){
+		if(key[depth + i] != prefix[i]){
+			return i;
+		}
+	}
+
+	return i;
+}
+
+/*Adds the child of the byte to the node, which must not be full.*/
+void art_node_put_child(art_node_t* node, unsigned char byte, art_node_t* child){
+	art_node_t** children = art_node_children(node);
+
+	if(node->type == NODE48){
+		children[node->count] = child;
+		((art_node48_t*)node)->indexes[byte] = (unsigned char)(node->count + 1);
+	}
+
+	else if(node->type == NODE256){
+		children[byte] = child;
+	}
+
+	else{
+		unsigned char* keys = art_node_keys(node);
+		size_t pos = node->count;
+
+		while(pos > 0 && keys[pos - 1] > byte){
+			pos--;
+		}
+
+		memmove(&keys[pos + 1], &keys[pos], node->count - pos);
+		memmove(&children[pos + 1], &children[pos], sizeof(art_node_t*) * (node->count - pos));
+		keys[pos] = byte;
+		children[pos] = child;
+	}
+
+	node->count++;
+}
+
+/*Replaces the node the link points to by a new one of the given type,
+with its prefix and children. Returns false in the case of an error.*/
+bool art_node_resize(art_node_t** link, uint8_t type){
+	art_node_t* node = *link;
+	art_node_t* resized = art_node_create(type);
+
+	if(!resized){
+		return false;
+	}
+
+	art_node_set_prefix(resized, node->prefix, node->prefix_length);
+	art_node_t** children = art_node_children(node);
+
+	if(node->type == NODE48){
+		for(int b = 0; b < 256; b++){
+			unsigned char index = ((art_node48_t*)node)->indexes[b];
+
+			if(index){
+				art_node_put_child(resized, (unsigned char)b, children[index - 1]);
+			}
+		}
+	}
+
+	else if(node->type == NODE256){
+		for(int b = 0; b < 256; b++){
+			if(children[b]){
+				art_node_put_child(resized, (unsigned char)b, children[b]);
+			}
+		}
+	}
+
+	else{
+		for(size_t i = 0; i < node->count; i++){
+			art_node_put_child(resized, art_node_keys(node)[i], children[i]);
+		}
+	}
+
+	*link = resized;
+	free(node);
+	return true;
+}
+
+/*Adds the child of the byte to the node the link points to, replacing
+it by a bigger one if it is full. Returns false in the case of an error.*/
+bool art_node_add_child(art_node_t** link, unsigned char byte, art_node_t* child){
+	static const uint16_t capacities[] = {4, 16, 48, 256};
+	art_node_t* node = *link;
+
+	if(node->count == capacities[node->type] && !art_node_resize(link, (uint8_t)(node->type + 1))){
+		return false;
+	}
+
+	art_node_put_child(*link, byte, child);
+	return true;
+}
+
+/*Replaces the NODE4 the link points to, which has a single child, by that
+child (moving the prefix and the byte of the child into it).*/
+void art_node_collapse(art_node_t** link){
+	art_node4_t* node = (art_node4_t*)*link;
+	art_node_t* child = node->children[0];
+
+	if(!art_is_leaf(child)){
+		unsigned char prefix[MAX_PREFIX];
+		size_t length = node->node.prefix_length < MAX_PREFIX ? node->node.prefix_length : MAX_PREFIX;
+		memcpy(prefix, node->node.prefix, length);
+
+		if(length < MAX_PREFIX){
+			prefix[length++] = node->keys[0];
+		}
+
+		size_t child_length = child->prefix_length < MAX_PREFIX - length ? child->prefix_length : MAX_PREFIX - length;
+		memcpy(prefix + length, child->prefix, child_length);
+		child->prefix_length += node->node.prefix_length + 1;
+		memcpy(child->prefix, prefix, length + child_length);
+	}
+
+	*link = child;
+	free(node);
+}
+
+/*Removes the child of the byte from the node the link points to, and
+replaces the node by a smaller one (or by its only child) if it has few
+children left.*/
+void art_node_remove_child(art_node_t** link, unsigned char byte){
+	art_node_t* node = *link;
+	art_node_t** children = art_node_children(node);
+
+	if(node->type == NODE48){
+		/*The last child goes to the free position.*/
+		unsigned char* indexes = ((art_node48_t*)node)->indexes;
+		unsigned char pos = (unsigned char)(indexes[byte] - 1);
+		indexes[byte] = 0;
+		children[pos] = children[node->count - 1];
+
+		for(int b = 0; pos != node->count - 1 && b < 256; b++){
+			if(indexes[b] == node->count){
+				indexes[b] = (unsigned char)(pos + 1);
+				break;
+			}
+		}
+	}
+
+	else if(node->type == NODE256){
+		children[byte] = NULL;
+	}
+
+	else{
+		unsigned char* keys = art_node_keys(node);
+		size_t pos = (size_t)(art_node_find_child(node, byte) - children);
+		memmove(&keys[pos], &keys[pos + 1], node->count - pos - 1);
+		memmove(&children[pos], &children[pos + 1], sizeof(art_node_t*) * (node->count - pos - 1));
+	}
+
+	node->count--;
+
+	/*Failing to shrink a node only wastes memory.*/
+	if(node->type == NODE4 && node->count == 1){
+		art_node_collapse(link);
+	}
+
+	else if((node->type == NODE16 && node->count <= 3) ||
+	        (node->type == NODE48 && node->count <= 12) ||
+	        (node->type == NODE256 && node->count <= 40)){
+		art_node_resize(link, (uint8_t)(node->type - 1));
+	}
+}
+
+/*Moves the children of a NODE256 to the beginning of its array (after
+which it can only be destroyed).*/
+void art_node_compact(art_node_t* node){
+	art_node_t** children = art_node_children(node);
+	size_t count = 0;
+
+	for(int b = 0; b < 256; b++){
+		if(children[b]){
+			children[count++] = children[b];
+		}
+	}
+}
+
+/*Links the leaf, which was just added to the node below the byte, between
+the leaves before and after it.*/
+void art_link_leaf(bst_t* bst, art_node_t* node, unsigned char byte, art_leaf_t* leaf){
+	art_node_t* before = art_node_child_before(node, byte);
+
+	if(before){
+		art_leaf_t* prev = art_last_leaf(before);
+		leaf->prev = prev;
+		leaf->next = prev->next;
+	}
+
+	else{
+		art_leaf_t* next = art_first_leaf(art_node_child_after(node, byte));
+		leaf->prev = next->prev;
+		leaf->next = next;
+	}
+
+	if(leaf->prev){
+		leaf->prev->next = leaf;
+	}
+
+	else{
+		bst->first = leaf;
+	}
+
+	if(leaf->next){
+		leaf->next->prev = leaf;
+	}
+}
+
+/*Unlinks the leaf from the leaves before and after it.*/
+void art_unlink_leaf(bst_t* bst, art_leaf_t* leaf){
+	if(leaf->prev){
+		leaf->prev->next = leaf->next;
+	}
+
+	else{
+		bst->first = leaf->next;
+	}
+
+	if(leaf->next){
+		leaf->next->prev = leaf->prev;
+	}
+}
+
+/*Replaces the subtree the link points to (which is 'depth' bytes below
+the root, and does not have the key) by a NODE4 whose prefix is the part
+of the subtree's prefix that matches the key, with two children: the
+subtree (with the rest of its prefix) and a new leaf. Returns false in the
+case of an error.*/
+bool art_split(bst_t* bst, art_node_t** link, size_t depth, const char* key, void* data){
+	const unsigned char* bytes = (const unsigned char*)key;
+	art_node_t* subtree = *link;
+	art_node_t* node = art_node_create(NODE4);
+	art_leaf_t* leaf = art_leaf_create(key, data);
+
+	if(!node || !leaf){
+		free(node);
+		free(leaf);
+		return false;
+	}
+
+	/*A leaf is split at the first byte where the keys differ, and an inner
+	node where its prefix does.*/
+	const unsigned char* prefix;
+	size_t matched;
+
+	if(art_is_leaf(subtree)){
+		prefix = (const unsigned char*)art_node_leaf(subtree)->key + depth;
+		matched = 0;
+
+		while(prefix[matched] == bytes[depth + matched]){
+			matched++;
+		}
+	}
+
+	else{
+		matched = art_node_match_prefix(subtree, bytes, depth);
+		prefix = art_node_prefix(subtree, depth);
+	}
+
+	unsigned char subtree_byte = prefix[matched];
+	art_node_set_prefix(node, bytes + depth, matched);
+
+	if(!art_is_leaf(subtree)){
+		art_node_set_prefix(subtree, prefix + matched + 1, subtree->prefix_length - matched - 1);
+	}
+
+	art_node_put_child(node, subtree_byte, subtree);
+	art_node_put_child(node, bytes[depth + matched], art_leaf_node(leaf));
+	*link = node;
+	art_link_leaf(bst, node, bytes[depth + matched], leaf);
+	return true;
+}
+
+/*Returns the leaf of the key, or NULL if it is not in the bst.*/
+art_leaf_t* art_search(const bst_t* bst, const char* key){
+	const unsigned char* bytes = (const unsigned char*)key;
+	size_t length = strlen(key);
+	art_node_t* node = bst->root;
+	size_t depth = 0;
+
+	while(node && !art_is_leaf(node)){
+		/*Only the kept part of the prefix is checked: the whole key is
+		compared with the one in the leaf.*/
+		for(size_t i = 0; i < node->prefix_length && i < MAX_PREFIX; i++){
+			if(bytes[depth + i] != node->prefix[i]){
+				return NULL;
+			}
+		}
+
+		depth += node->prefix_length;
+
+		if(depth > length){
+			return NULL;
+		}
+
+		art_node_t** child = art_node_find_child(node, bytes[depth]);
+		node = child ? *child : NULL;
+		depth++;
+	}
+
+	if(!node || strcmp(art_node_leaf(node)->key, key) != 0){
+		return NULL;
+	}
+
+	return art_node_leaf(node);
+}
+
+/*Returns the leaf of the first key that is not less than 'from', or NULL
+if there is none.*/
+art_leaf_t* art_lower_bound(const bst_t* bst, const char* from){
+	const unsigned char* bytes = (const unsigned char*)from;
+	art_node_t* node = bst->root;
+	size_t depth = 0;
+
+	if(!node){
+		return NULL;
+	}
+
+	while(!art_is_leaf(node)){
+		/*If the prefix does not match, every key below the node is either
+		greater or less than 'from'.*/
+		const unsigned char* prefix = art_node_prefix(node, depth);
+
+		for(size_t i = 0; i < node->prefix_length; i++){
+			if(bytes[depth + i] != prefix[i]){
+				return bytes[depth + i] < prefix[i] ? art_first_leaf(node) : art_last_leaf(node)->next;
+			}
+		}
+
+		depth += node->prefix_length;
+		art_node_t** child = art_node_find_child(node, bytes[depth]);
+
+		if(!child){
+			art_node_t* after = art_node_child_after(node, bytes[depth]);
+			return after ? art_first_leaf(after) : art_last_leaf(node)->next;
+		}
+
+		node = *child;
+		depth++;
+	}
+
+	art_leaf_t* leaf = art_node_leaf(node);
+	return strcmp(leaf->key, from) >= 0 ? leaf : leaf->next;
+}
+
+/*Moves the iterator to the end if its current key is not before its end.*/
+void bst_iter_check_end(bst_iter_t* iter){
+	if(iter->end && iter->current && strcmp(iter->current->key, iter->end) >= 0){
+		iter->current = NULL;
+	}
+}
+
+/*******************************************************************
+ * Primitives
+ ******************************************************************/
+
+/*bst*/
+
+bst_t* bst_create(bst_compare_key_t cmp, bst_destroy_data_t destroy_data){
+	(void)cmp;
+	bst_t* bst = malloc(sizeof(bst_t));
+
+	if(!bst) {
+		return NULL;
+	}
+
+	bst->root = NULL;
+	bst->first = NULL;
+	bst->destroy_data = destroy_data;
+	bst->items = 0;
+	return bst;
+}
+
+bool bst_store(bst_t *bst, const char *key, void *data){
+	const unsigned char* bytes = (const unsigned char*)key;
+	art_node_t** link = &bst->root;
+	size_t depth = 0;
+
+	if(!bst->root){
+		art_leaf_t* leaf = art_leaf_create(key, data);
+
+		if(!leaf){
+			return false;
+		}
+
+		bst->root = art_leaf_node(leaf);
+		bst->first = leaf;
+		bst->items++;
+		return true;
+	}
+
+	while(!art_is_leaf(*link)){
+		art_node_t* node = *link;
+
+		if(art_node_match_prefix(node, bytes, depth) < node->prefix_length){
+			break;
+		}
+
+		depth += node->prefix_length;
+		art_node_t** child = art_node_find_child(node, bytes[depth]);
+
+		if(!child){
+			art_leaf_t* leaf = art_leaf_create(key, data);
+
+			if(!leaf || !art_node_add_child(link, bytes[depth], art_leaf_node(leaf))){
+				free(leaf);
+				return false;
+			}
+
+			art_link_leaf(bst, *link, bytes[depth], leaf);
+			bst->items++;
+			return true;
+		}
+
+		link = child;
+		depth++;
+	}
+
+	if(art_is_leaf(*link) && strcmp(art_node_leaf(*link)->key, key) == 0){
+		art_leaf_t* leaf = art_node_leaf(*link);
+		void* old_data = leaf->data;
+		leaf->data = data;
+
+		if(bst->destroy_data) {
+			bst->destroy_data(old_data);
+		}
+
+		return true;
+	}
+
+	if(!art_split(bst, link, depth, key, data)){
+		return false;
+	}
+
+	bst->items++;
+	return true;
+}
+
+void *bst_remove(bst_t *bst, const char *key){
+	const unsigned char* bytes = (const unsigned char*)key;
+	size_t length = strlen(key);
+	art_node_t** link = &bst->root;
+	art_node_t** parent_link = NULL;
+	size_t depth = 0;
+
+	while(*link && !art_is_leaf(*link)){
+		art_node_t* node = *link;
+
+		for(size_t i = 0; i < node->prefix_length && i < MAX_PREFIX; i++){
+			if(bytes[depth + i] != node->prefix[i]){
+				return NULL;
+			}
+		}
+
+		depth += node->prefix_length;
+
+		if(depth > length){
+			return NULL;
+		}
+
+		art_node_t** child = art_node_find_child(node, bytes[depth]);
+
+		if(!child){
+			return NULL;
+		}
+
+		parent_link = link;
+		link = child;
+		depth++;
+	}
+
+	if(!*link || strcmp(art_node_leaf(*link)->key, key) != 0){
+		return NULL;
+	}
+
+	art_leaf_t* leaf = art_node_leaf(*link);
+	void* data = leaf->data;
+	art_unlink_leaf(bst, leaf);
+	free(leaf);
+
+	if(parent_link){
+		art_node_remove_child(parent_link, bytes[depth - 1]);
+	}
+
+	else{
+		bst->root = NULL;
+	}
+
+	bst->items--;
+	return data;
+}
+
+void *bst_get(const bst_t *bst, const char *key){
+	art_leaf_t* leaf = art_search(bst, key);
+
+	if(!leaf) {
+		return NULL;
+	}
+
+	return leaf->data;
+}
+
+bool bst_contains(const bst_t *bst, const char *key){
+	return art_search(bst, key) != NULL;
+}
+
+size_t bst_size(bst_t *bst){
+	return bst->items;
+}
+
+void bst_destroy(bst_t *bst){
+	art_node_t* node = bst->root;
+	art_node_t* parent = NULL;
+
+	/*Inner nodes are freed without a stack: the link to the parent of a
+	node is kept in the position of the parent's child being freed, which
+	is no longer used (children are taken from the last one, and those of
+	a NODE256 are first moved to the beginning).*/
+	if(node && !art_is_leaf(node) && node->type == NODE256){
+		art_node_compact(node);
+	}
+
+	while(node && !art_is_leaf(node)){
+		art_node_t** children = art_node_children(node);
+
+		if(node->count == 0){
+			art_node_t* up = parent;
+
+			if(up){
+				parent = art_node_children(up)[up->count];
+			}
+
+			free(node);
+			node = up;
+			continue;
+		}
+
+		art_node_t* child = children[--node->count];
+
+		if(art_is_leaf(child)){
+			continue;
+		}
+
+		children[node->count] = parent;
+		parent = node;
+		node = child;
+
+		if(node->type == NODE256){
+			art_node_compact(node);
+		}
+	}
+
+	art_leaf_t* leaf = bst->first;
+
+	while(leaf){
+		art_leaf_t* next = leaf->next;
+
+		if(bst->destroy_data){
+			bst->destroy_data(leaf->data);
+		}
+
+		free(leaf);
+		leaf = next;
+	}
+
+	free(bst);
+}
+
+/*Inner Iterator*/
+
+void bst_visit(bst_t *bst, bool visit(const char *, void *, void *), void *extra){
+	bst_visit_range(bst, NULL, NULL, visit, extra);
+}
+
+void bst_visit_range(bst_t *bst, const char *from, const char *to,
+                     bool visit(const char *, void *, void *), void *extra){
+	bst_iter_t iter;
+	bst_iter_init(&iter, bst, from, to);
+
+	while(iter.current){
+		if(!visit(iter.current->key, iter.current->data, extra)){
+			return;
+		}
+
+		bst_iter_next(&iter);
+	}
+}
+
+/*Outer iterator*/
+
+bst_iter_t *bst_iter_create(const bst_t *bst){
+	return bst_iter_create_range(bst, NULL, NULL);
+}
+
+bst_iter_t *bst_iter_create_from(const bst_t *bst, const char *from){
+	return bst_iter_create_range(bst, from, NULL);
+}
+
+bst_iter_t *bst_iter_create_range(const bst_t *bst, const char *from, const char *to){
+	/*The copy of 'to' goes right after the iterator.*/
+	size_t end_size = to ? strlen(to) + 1 : 0; //\0
+	bst_iter_t* iter = malloc(sizeof(bst_iter_t) + end_size);
+
+	if(!iter) {
+		return NULL;
+	}
+
+	if(to){
+		to = memcpy(iter + 1, to, end_size);
+	}
+
+	bst_iter_init(iter, bst, from, to);
+	return iter;
+}
+
+void bst_iter_init(bst_iter_t *iter, const bst_t *bst, const char *from, const char *to){
+	iter->current = from ? art_lower_bound(bst, from) : bst->first;
+	iter->end = to;
+	bst_iter_check_end(iter);
+}
+
+bool bst_iter_next(bst_iter_t *iter){
+	if(!iter->current){
+		return false;
+	}
+
+	iter->current = iter->current->next;
+	bst_iter_check_end(iter);
+	return true;
+}
+
+const char *bst_iter_get_current(const bst_iter_t *iter){
+	if(!iter->current) {
+		return NULL;
+	}
+
+	return iter->current->key;
+}
+
+bool bst_iter_at_end(const bst_iter_t *iter){
+	return iter->current == NULL;
+}
+
+void bst_iter_destroy(bst_iter_t* iter){
+	free(iter);
+}
@@ -0,0 +1,419 @@
+#include "swiss_hash.h"
+#include "hash_function.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define CAPACITY 16
+#define GROUP_WIDTH 16
+#define MAX_LOAD_NUMERATOR 7
+#define MAX_LOAD_DENOMINATOR 8
+
+#define CTRL_EMPTY ((int8_t)-128)
+#define CTRL_REMOVED ((int8_t)-2)
+
+/*******************************************************************
+ *Structures
+ ******************************************************************/
+
+typedef struct hash_slot{
+	char* key;
+	void* value;
+}hash_slot_t;
+
+/*'ctrl' has 'size' + GROUP_WIDTH bytes: the last GROUP_WIDTH ones are a
+copy of the first ones, so a group can be read from any position without
+wrapping around. A control byte is CTRL_EMPTY, CTRL_REMOVED, or the lower
+7 bits of the hash of the key stored in the slot.
+'growth_left' is the number of empty slots that can still be filled
+before the table has to be rehashed.*/
+struct hash{
+	int8_t* ctrl;
+	hash_slot_t* slots;
+	size_t items;
+	size_t size;
+	size_t growth_left;
+	hash_function_t hash_function;
+	hash_destroy_data_t destroy;
+};
+
+struct hash_iter{
+	const hash_t* hash;
+	size_t position;
+};
+
+/*******************************************************************
+ *Auxiliary Functions
+ ******************************************************************/
+
+/*Hashes the key with the function of the table.*/
+uint64_t hashing(const hash_t* hash, const char *key){
+	return hash->hash_function(key, strlen(key));
+}
+
+/*Upper bits of the hash: position where probing starts.*/
+size_t hash_h1(uint64_t key_hash){
+	return (size_t)(key_hash >> 7);
+}
+
+/*Lower 7 bits of the hash: stored in the control byte.*/
+int8_t hash_h2(uint64_t key_hash){
+	return (int8_t)(key_hash & 0x7F);
+}
+
+/*Returns a bit mask with the positions of the group (starting at 'group')
+whose control byte is equal to 'value'.*/
+uint32_t group_match(const int8_t* group, int8_t value){
+#ifdef __SSE2__
+	__m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), ctrl));
+#else
+	uint32_t mask = 0;
+
+	for(int i = 0; i < GROUP_WIDTH; i++){
+		if(group[i] == value){
+			mask |= (uint32_t)1 << i;
+		}
+	}
+
+	return mask;
+#endif
+}
+
+/*Returns a bit mask with the empty or removed positions of the group.*/
+uint32_t group_match_free(const int8_t* group){
+#ifdef __SSE2__
+	__m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+	return (uint32_t)_mm_movemask_epi8(ctrl);
+#else
+	uint32_t mask = 0;
+
+	for(int i = 0; i < GROUP_WIDTH; i++){
+		if(group[i] < 0){
+			mask |= (uint32_t)1 << i;
+		}
+	}
+
+	return mask;
+#endif
+}
+
+/*Index of the lowest set bit of a non zero mask.*/
+unsigned mask_lowest(uint32_t mask){
+	unsigned pos = 0;
+
+	while(!(mask & 1)){
+		mask >>= 1;
+		pos++;
+	}
+
+	return pos;
+}
+
+/*Index of the highest set bit of a non zero mask.*/
+unsigned mask_highest(uint32_t mask){
+	unsigned pos = 0;
+
+	while(mask >>= 1){
+		pos++;
+	}
+
+	return pos;
+}
+
+/*Sets the control byte of a slot, keeping the copy at the end updated.*/
+void hash_set_ctrl(hash_t* hash, size_t pos, int8_t value){
+	hash->ctrl[pos] = value;
+
+	if(pos < GROUP_WIDTH){
+		hash->ctrl[hash->size + pos] = value;
+	}
+}
+
+/*Returns the position of the slot holding the key, or hash->size if the
+key is not in the table.*/
+size_t hash_find(const hash_t* hash, uint64_t key_hash, const char* key){
+	size_t mask = hash->size - 1;
+	size_t pos = hash_h1(key_hash) & mask;
+	int8_t h2 = hash_h2(key_hash);
+
+	for(size_t probe = 1; probe <= hash->size / GROUP_WIDTH; probe++){
+		const int8_t* group = hash->ctrl + pos;
+		uint32_t match = group_match(group, h2);
+
+		while(match){
+			size_t slot = (pos + mask_lowest(match)) & mask;
+
+			if(strcmp(hash->slots[slot].key, key) == 0){
+				return slot;
+			}
+
+			match &= match - 1;
+		}
+
+		if(group_match(group, CTRL_EMPTY)){
+			break;
+		}
+
+		pos = (pos + GROUP_WIDTH * probe) & mask;
+	}
+
+	return hash->size;
+}
+
+/*Returns the first empty or removed slot of the probe sequence of the hash.*/
+size_t hash_find_free(const hash_t* hash, uint64_t key_hash){
+	size_t mask = hash->size - 1;
+	size_t pos = hash_h1(key_hash) & mask;
+
+	for(size_t probe = 1; ; probe++){
+		uint32_t match = group_match_free(hash->ctrl + pos);
+
+		if(match){
+			return (pos + mask_lowest(match)) & mask;
+		}
+
+		pos = (pos + GROUP_WIDTH * probe) & mask;
+	}
+}
+
+/*Allocates empty arrays with the given size (a power of two).*/
+bool hash_alloc(hash_t* hash, size_t size){
+	int8_t* ctrl = malloc(size + GROUP_WIDTH);
+	hash_slot_t* slots = malloc(sizeof(hash_slot_t) * size);
+
+	if(!ctrl || !slots){
+		free(ctrl);
+		free(slots);
+		return false;
+	}
+
+	memset(ctrl, CTRL_EMPTY, size + GROUP_WIDTH);
+	hash->ctrl = ctrl;
+	hash->slots = slots;
+	hash->size = size;
+	hash->growth_left = size * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR;
+	return true;
+}
+
+/*Rehashes every element into new arrays. The size is doubled, unless
+most of the used slots are removed ones (then it is kept).*/
+bool hash_resize(hash_t* hash){
+	size_t new_size = hash->size;
+
+	if(hash->items * 2 * MAX_LOAD_DENOMINATOR > hash->size * MAX_LOAD_NUMERATOR){
+		new_size *= 2;
+	}
+
+	int8_t* old_ctrl = hash->ctrl;
+	hash_slot_t* old_slots = hash->slots;
+	size_t old_size = hash->size;
+
+	if(!hash_alloc(hash, new_size)){
+		return false;
+	}
+
+	for(size_t pos = 0; pos < old_size; pos++){
+		if(old_ctrl[pos] >= 0){
+			uint64_t key_hash = hashing(hash, old_slots[pos].key);
+			size_t new_pos = hash_find_free(hash, key_hash);
+			hash_set_ctrl(hash, new_pos, hash_h2(key_hash));
+			hash->slots[new_pos] = old_slots[pos];
+		}
+	}
+
+	hash->growth_left -= hash->items;
+	free(old_ctrl);
+	free(old_slots);
+	return true;
+}
+
+/*******************************************************************
+ *Primitives
+ ******************************************************************/
+
+hash_t *hash_create(hash_destroy_data_t destroy_data){
+	hash_t* hash = malloc(sizeof(hash_t));
+
+	if(!hash){
+		return NULL;
+	}
+
+	if(!hash_alloc(hash, CAPACITY)){
+		free(hash);
+		return NULL;
+	}
+
+	hash->items = 0;
+	hash->hash_function = hash_function_wyhash;
+	hash->destroy = destroy_data;
+	return hash;
+}
+
+void hash_destroy(hash_t *hash){
+	for(size_t pos = 0; pos < hash->size; pos++){
+		if(hash->ctrl[pos] >= 0){
+			if(hash->destroy){
+				hash->destroy(hash->slots[pos].value);
+			}
+
+			free(hash->slots[pos].key);
+		}
+	}
+
+	free(hash->ctrl);
+	free(hash->slots);
+	free(hash);
+}
+
+bool hash_set_hash_function(hash_t *hash, hash_function_t hash_function){
+	if(hash->items != 0){
+		return false;
+	}
+
+	hash->hash_function = hash_function;
+	return true;
+}
+
+size_t hash_size(const hash_t *hash){
+	return hash->items;
+}
+
+bool hash_store(hash_t *hash, const char *key, void *data){
+	uint64_t key_hash = hashing(hash, key);
+	size_t pos = hash_find(hash, key_hash, key);
+
+	if(pos != hash->size){
+		if(hash->destroy){
+			hash->destroy(hash->slots[pos].value);
+		}
+
+		hash->slots[pos].value = data;
+		return true;
+	}
+
+	char* key_copy = malloc(strlen(key) + 1);
+
+	if(!key_copy){
+		return false;
+	}
+
+	strcpy(key_copy, key);
+	pos = hash_find_free(hash, key_hash);
+
+	if(hash->growth_left == 0 && hash->ctrl[pos] == CTRL_EMPTY){
+		if(!hash_resize(hash)){
+			free(key_copy);
+			return false;
+		}
+
+		pos = hash_find_free(hash, key_hash);
+	}
+
+	if(hash->ctrl[pos] == CTRL_EMPTY){
+		hash->growth_left--;
+	}
+
+	hash_set_ctrl(hash, pos, hash_h2(key_hash));
+	hash->slots[pos].key = key_copy;
+	hash->slots[pos].value = data;
+	hash->items++;
+	return true;
+}
+
+void *hash_remove(hash_t *hash, const char *key){
+	size_t pos = hash_find(hash, hashing(hash, key), key);
+
+	if(pos == hash->size){
+		return NULL;
+	}
+
+	void* value = hash->slots[pos].value;
+	free(hash->slots[pos].key);
+	hash->items--;
+
+	/*The slot can be emptied only if no probe sequence ever found a full
+	group around it (otherwise probing would stop too early).*/
+	size_t mask = hash->size - 1;
+	uint32_t empty_after = group_match(hash->ctrl + pos, CTRL_EMPTY);
+	uint32_t empty_before = group_match(hash->ctrl + ((pos - GROUP_WIDTH) & mask), CTRL_EMPTY);
+
+	if(empty_after && empty_before &&
+	   mask_lowest(empty_after) + (GROUP_WIDTH - 1 - mask_highest(empty_before)) < GROUP_WIDTH){
+		hash_set_ctrl(hash, pos, CTRL_EMPTY);
+		hash->growth_left++;
+	}
+
+	else{
+		hash_set_ctrl(hash, pos, CTRL_REMOVED);
+	}
+
+	return value;
+}
+
+void* hash_get(const hash_t *hash, const char *key){
+	size_t pos = hash_find(hash, hashing(hash, key), key);
+
+	if(pos == hash->size){
+		return NULL;
+	}
+
+	return hash->slots[pos].value;
+}
+
+bool hash_is_in(const hash_t *hash, const char *key){
+	return hash_find(hash, hashing(hash, key), key) != hash->size;
+}
+
+/*Iterator*/
+
+hash_iter_t *hash_iter_create(const hash_t *hash){
+	hash_iter_t* iter = malloc(sizeof(hash_iter_t));
+
+	if(!iter){
+		return NULL;
+	}
+
+	iter->hash = hash;
+	iter->position = 0;
+
+	while(iter->position != hash->size && hash->ctrl[iter->position] < 0){
+		iter->position++;
+	}
+
+	return iter;
+}
+
+bool hash_iter_at_end(const hash_iter_t *iter){
+	return (iter->position == iter->hash->size);
+}
+
+bool hash_iter_next(hash_iter_t *iter){
+	if(hash_iter_at_end(iter)){
+		return false;
+	}
+
+	iter->position++;
+
+	while(!hash_iter_at_end(iter) && iter->hash->ctrl[iter->position] < 0){
+		iter->position++;
+	}
+
+	return true;
+}
+
+const char *hash_iter_get_current(const hash_iter_t *iter){
+	if(hash_iter_at_end(iter)){
+		return NULL;
+	}
+
+	return iter->hash->slots[iter->position].key;
+}
+
+void hash_iter_destroy(hash_iter_t* iter){
+	free(iter);
+}